@@ -0,0 +1,198 @@
+/* Incremental run-by-run combination of ALL.
+ * Fill() takes one run's ALL and error for a part (same part index as in
+ * isophoton-asym and pion-asym) and updates the sufficient statistics
+ * sum(w), sum(w*ALL), sum(w*ALL^2) with w = 1/error^2, so the weighted mean,
+ * its error and chi2 are available at any time, as the pol0 fit to the
+ * run-by-run graph. Retract() removes all parts of a run again, GetRun()
+ * returns the parts of a run as they were filled.
+ * Save()/Load() keep the per-run values in a tree, so the accumulator can be
+ * updated when new runs are processed; Load() adds to the current runs. */
+class ALLAccumulator
+{
+  public:
+    ALLAccumulator() {}
+
+    void Fill(int runnumber, int part, double value, double error);
+    bool Retract(int runnumber);
+    bool HasRun(int runnumber) const { return _run_part.find(runnumber) != _run_part.end(); }
+    int GetNRuns() const { return _run_part.size(); }
+    bool GetRun(int runnumber, vector<int> &parts, vector<double> &values, vector<double> &errors) const;
+    vector<int> GetRuns() const;
+
+    bool Get(int part, double &value, double &error) const;
+    bool Get(int part, double &value, double &error, double &chi2, int &ndf) const;
+
+    void Save(const char *fname) const;
+    void Load(const char *fname);
+
+  protected:
+    void Add(int part, double value, double error, int sign);
+
+    map< int, vector<int> > _run_part;
+    map< int, vector<double> > _run_value;
+    map< int, vector<double> > _run_error;
+
+    map<int, double> _sumw;
+    map<int, double> _sumx;
+    map<int, double> _sumx2;
+    map<int, int> _sumN;
+};
+
+void ALLAccumulator::Fill(int runnumber, int part, double value, double error)
+{
+  if( !TMath::Finite(value+error) || error <= 0. )
+    return;
+
+  _run_part[runnumber].push_back(part);
+  _run_value[runnumber].push_back(value);
+  _run_error[runnumber].push_back(error);
+  Add(part, value, error, 1);
+}
+
+bool ALLAccumulator::Retract(int runnumber)
+{
+  if( !HasRun(runnumber) )
+    return false;
+
+  vector<int> &parts = _run_part[runnumber];
+  vector<double> &values = _run_value[runnumber];
+  vector<double> &errors = _run_error[runnumber];
+  for(unsigned i=0; i<parts.size(); i++)
+    Add(parts[i], values[i], errors[i], -1);
+
+  _run_part.erase(runnumber);
+  _run_value.erase(runnumber);
+  _run_error.erase(runnumber);
+  return true;
+}
+
+bool ALLAccumulator::GetRun(int runnumber, vector<int> &parts, vector<double> &values, vector<double> &errors) const
+{
+  if( !HasRun(runnumber) )
+    return false;
+
+  parts = _run_part.find(runnumber)->second;
+  values = _run_value.find(runnumber)->second;
+  errors = _run_error.find(runnumber)->second;
+  return true;
+}
+
+vector<int> ALLAccumulator::GetRuns() const
+{
+  vector<int> runs;
+  for(map< int, vector<int> >::const_iterator it=_run_part.begin(); it!=_run_part.end(); ++it)
+    runs.push_back(it->first);
+  return runs;
+}
+
+bool ALLAccumulator::Get(int part, double &value, double &error) const
+{
+  double chi2;
+  int ndf;
+  return Get(part, value, error, chi2, ndf);
+}
+
+bool ALLAccumulator::Get(int part, double &value, double &error, double &chi2, int &ndf) const
+{
+  value = 0.;
+  error = 0.;
+  chi2 = 0.;
+  ndf = 0;
+
+  map<int, double>::const_iterator it = _sumw.find(part);
+  if( it == _sumw.end() || it->second <= 0. )
+    return false;
+
+  double sumw = it->second;
+  double sumx = _sumx.find(part)->second;
+  double sumx2 = _sumx2.find(part)->second;
+  int sumN = _sumN.find(part)->second;
+
+  value = sumx/sumw;
+  error = 1./sqrt(sumw);
+  chi2 = TMath::Max(sumx2 - sumw*value*value, 0.);
+  ndf = sumN - 1;
+  return true;
+}
+
+void ALLAccumulator::Save(const char *fname) const
+{
+  int runnumber, part;
+  double value, error;
+
+  TFile *f = new TFile(fname, "RECREATE");
+  TTree *t = new TTree("t_all", "Run-by-run ALL");
+  t->Branch("runnumber", &runnumber, "runnumber/I");
+  t->Branch("part", &part, "part/I");
+  t->Branch("value", &value, "value/D");
+  t->Branch("error", &error, "error/D");
+
+  for(map< int, vector<int> >::const_iterator it=_run_part.begin(); it!=_run_part.end(); ++it)
+  {
+    runnumber = it->first;
+    const vector<double> &values = _run_value.find(runnumber)->second;
+    const vector<double> &errors = _run_error.find(runnumber)->second;
+    for(unsigned i=0; i<it->second.size(); i++)
+    {
+      part = it->second[i];
+      value = values[i];
+      error = errors[i];
+      t->Fill();
+    }
+  }
+
+  f->cd();
+  t->Write();
+  f->Close();
+  delete f;
+}
+
+void ALLAccumulator::Load(const char *fname)
+{
+  TFile *f = new TFile(fname);
+  TTree *t = f->IsZombie() ? 0 : (TTree*)f->Get("t_all");
+  if(!t)
+  {
+    cout << "ALLAccumulator: no tree in " << fname << endl;
+    delete f;
+    return;
+  }
+
+  int runnumber, part;
+  double value, error;
+  t->SetBranchAddress("runnumber", &runnumber);
+  t->SetBranchAddress("part", &part);
+  t->SetBranchAddress("value", &value);
+  t->SetBranchAddress("error", &error);
+
+  /* Runs in the file replace runs already present */
+  for(int ien=0; ien<t->GetEntries(); ien++)
+  {
+    t->GetEntry(ien);
+    Retract(runnumber);
+  }
+  for(int ien=0; ien<t->GetEntries(); ien++)
+  {
+    t->GetEntry(ien);
+    Fill(runnumber, part, value, error);
+  }
+
+  delete f;
+}
+
+void ALLAccumulator::Add(int part, double value, double error, int sign)
+{
+  double w = 1./error/error;
+  _sumw[part] += sign*w;
+  _sumx[part] += sign*w*value;
+  _sumx2[part] += sign*w*value*value;
+  _sumN[part] += sign;
+  if( _sumN[part] == 0 )
+  {
+    /* Remove rounding leftovers once the last run is gone */
+    _sumw.erase(part);
+    _sumx.erase(part);
+    _sumx2.erase(part);
+    _sumN.erase(part);
+  }
+}
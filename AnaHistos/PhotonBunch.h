@@ -0,0 +1,95 @@
+#include <TFile.h>
+#include <TH2.h>
+
+/* Polarized photon yields per bunch from the PhotonHistos output.
+ * All bunches are in one histogram h2_photon_bunch with pT in the npT_pol
+ * ALL bins on the X axis and the index on the Y axis
+ * ih = imul + 6*evenodd + 6*2*(bunch/2) + 6*2*60*checkmap + 6*2*60*2*ical
+ * imul = 0 not isolated and 1 isolated photons,
+ * 2 + 2*pttype and 3 + 2*pttype pi0 peak and sideband (pttype 0 pT, 1 pair pT).
+ * Older files have one TH1 h_photon_bunch_<ih> per index instead, the TH2 is
+ * then built from them. */
+class PhotonBunch
+{
+  public:
+    PhotonBunch(TFile *f, int checkmap = 1, int ical = 0):
+      _h2( (TH2*)f->Get("h2_photon_bunch") ),
+      _owned(false),
+      _offset( 6*2*60*checkmap + 6*2*60*2*ical )
+    {
+      if(!_h2)
+      {
+        _h2 = FromBunchHistos(f);
+        _owned = true;
+      }
+    }
+
+    ~PhotonBunch()
+    {
+      if(_owned)
+        delete _h2;
+    }
+
+    bool IsValid() const { return _h2 != 0; }
+
+    /* ib = bunch/2 */
+    double Get(int imul, int evenodd, int ib, int ipt) const
+    {
+      return _h2->GetBinContent( ipt+1, Index(imul, evenodd, ib)+1 );
+    }
+
+    double GetError(int imul, int evenodd, int ib, int ipt) const
+    {
+      return _h2->GetBinError( ipt+1, Index(imul, evenodd, ib)+1 );
+    }
+
+  protected:
+    static const int nh = 6*2*60*2*2;
+
+    int Index(int imul, int evenodd, int ib) const
+    {
+      return imul + 6*evenodd + 6*2*ib + _offset;
+    }
+
+    /* TH2 from the per-index TH1s, 0 if there are none; indices never booked stay empty */
+    static TH2* FromBunchHistos(TFile *f)
+    {
+      TH2 *h2 = 0;
+      for(int ih=0; ih<nh; ih++)
+      {
+        TH1 *h = (TH1*)f->Get(Form("h_photon_bunch_%d",ih));
+        if(!h)
+          continue;
+
+        if(!h2)
+        {
+          const TAxis *axis = h->GetXaxis();
+          if( axis->GetXbins()->GetSize() > 0 )
+            h2 = new TH2D("h2_photon_bunch_fromTH1", "Polarized photon spectrum;p_{T} [GeV];ih;",
+                axis->GetNbins(), axis->GetXbins()->GetArray(), nh, -0.5, nh-0.5);
+          else
+            h2 = new TH2D("h2_photon_bunch_fromTH1", "Polarized photon spectrum;p_{T} [GeV];ih;",
+                axis->GetNbins(), axis->GetXmin(), axis->GetXmax(), nh, -0.5, nh-0.5);
+          h2->SetDirectory(0);
+          h2->Sumw2();
+        }
+
+        for(int ipt=0; ipt<=h->GetNbinsX()+1; ipt++)
+        {
+          h2->SetBinContent( ipt, ih+1, h->GetBinContent(ipt) );
+          h2->SetBinError( ipt, ih+1, h->GetBinError(ipt) );
+        }
+        delete h;
+      }
+      return h2;
+    }
+
+    TH2 *_h2;
+    bool _owned;
+    int _offset;
+
+  private:
+    /* The TH2 may be owned, no copies */
+    PhotonBunch(const PhotonBunch&);
+    PhotonBunch& operator=(const PhotonBunch&);
+};
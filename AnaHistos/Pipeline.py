@@ -0,0 +1,265 @@
+#!/usr/bin/python
+# Run the cross section correction chain, only redoing stages whose inputs changed.
+#
+# Each stage is a draw_* macro with its arguments, the files it reads and the
+# QueryTree files it writes. The key of a stage is the hash of the macro, the
+# local headers it includes, its arguments and the contents of its inputs.
+# A stage is skipped if its key and outputs match the last run, and outputs of
+# a key seen before are restored from the cache in data/.pipeline/ without
+# running ROOT. Stages whose inputs are ready run in parallel.
+#
+# Usage: ./Pipeline.py [-j 4] [-n] [-f stage] [stage ...]
+# Constants inside a macro (e.g. the BBC trigger efficiency in
+# draw_CrossSection_Photon.C) are part of its key, so changing them reruns
+# only that stage and the stages reading its outputs.
+
+from __future__ import print_function
+
+import argparse
+import hashlib
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import time
+
+MACROS = "/phenix/plhf/zji/github/phenix-directphotons-pp/fun4all/offline/analysis/Run13ppDirectPhoton"
+FASTMC = MACROS + "/AnaFastMC-macros"
+PHOTONNODE = MACROS + "/PhotonNode-macros"
+
+CACHEDIR = "data/.pipeline"
+STATEFILE = CACHEDIR + "/state.json"
+
+# name: (macro, arguments, inputs, outputs)
+STAGES = {
+    "Acceptance_Photon": ("draw_Acceptance_Photon.C", "",
+        [FASTMC + "/AnaFastMC-Fast-histo.root"],
+        ["data/Acceptance-photon.root"]),
+    "ERTEff_Photon": ("draw_ERTEff_Photon.C", "0",
+        [PHOTONNODE + "/PhotonHistos-DC3sigma.root",
+         FASTMC + "/HadronResponse-histo-photon.root"],
+        ["data/ERTEff-photon.root"]),
+    "MissingRatio": ("draw_MissingRatio.C", "",
+        [FASTMC + "/AnaFastMC-Fast-histo.root"],
+        ["data/MissingRatio.root", "data/MissingRatio-eta.root",
+         "data/Merge-1photon.root", "data/Merge-2photon.root"]),
+    "MergePassRate": ("draw_MergePassRate.C", "",
+        [FASTMC + "/MissingRatio-histo.root"],
+        ["data/MergePassRate.root"]),
+    "SelfVeto": ("draw_SelfVeto.C", "",
+        [FASTMC + "/AnaFastMC-Fast-histo.root"],
+        ["data/SelfVeto.root"]),
+    "SysErrEn": ("draw_SysErrEn.C", "",
+        [FASTMC + "/AnaFastMC-Fast-histo-syserr.root"],
+        ["data/syserr-en-fast.root"]),
+    "BgRatio": ("draw_BgRatio.C", "",
+        [PHOTONNODE + "/PhotonHistos-DC3sigma.root"],
+        ["data/BgRatio.root"]),
+    "BgRatio_IsoPhoton": ("draw_BgRatio_IsoPhoton.C", "",
+        [PHOTONNODE + "/PhotonHistos-Inseok.root",
+         "data/MissingRatio.root", "data/MissingRatio-eta.root",
+         "data/Merge-1photon.root", "data/Merge-2photon.root",
+         "data/MergePassRate.root", "data/SelfVeto.root"],
+        ["data/BgRatio-isophoton.root"]),
+    "PtShift": ("draw_PtShift.C", "",
+        [PHOTONNODE + "/PhotonHistos-DC3sigma.root",
+         "data/BgRatio-isophoton.root"],
+        ["data/PtShift.root"]),
+    "CrossSection_Photon": ("draw_CrossSection_Photon.C", "",
+        [PHOTONNODE + "/PhotonHistos-DC3sigma.root",
+         "data/Acceptance-photon.root", "data/ERTEff-photon.root",
+         "data/MissingRatio.root", "data/MissingRatio-eta.root",
+         "data/Merge-1photon.root", "data/Merge-2photon.root",
+         "data/MergePassRate.root", "data/syserr-en-fast.root",
+         "data/BgRatio.root", "data/PtShift.root"],
+        ["data/CrossSection-photon.root"]),
+}
+
+def Producers():
+    producer = {}
+    for name, (macro, args, inputs, outputs) in STAGES.items():
+        for out in outputs:
+            producer[out] = name
+    return producer
+
+def Dependencies(name, producer):
+    return sorted(set(producer[f] for f in STAGES[name][2] if f in producer))
+
+def Headers(fname, found=None):
+    """Local headers included by a macro, recursively"""
+    if found is None:
+        found = []
+    for line in open(fname):
+        m = re.match(r'\s*#include\s+"([^"]+)"', line)
+        if m and m.group(1) not in found and os.path.exists(m.group(1)):
+            found.append(m.group(1))
+            Headers(m.group(1), found)
+    return found
+
+def FileHash(fname, state):
+    """Content hash of a file, recomputed only when size or mtime change"""
+    st = os.stat(fname)
+    stamp = [st.st_size, int(st.st_mtime)]
+    entry = state["files"].get(fname)
+    if entry and entry[0] == stamp:
+        return entry[1]
+    h = hashlib.sha1()
+    with open(fname, "rb") as f:
+        for block in iter(lambda: f.read(1 << 20), b""):
+            h.update(block)
+    state["files"][fname] = [stamp, h.hexdigest()]
+    return h.hexdigest()
+
+def StageKey(name, state):
+    macro, args, inputs, outputs = STAGES[name]
+    h = hashlib.sha1()
+    for src in [macro] + Headers(macro):
+        h.update(src.encode())
+        h.update(FileHash(src, state).encode())
+    h.update(args.encode())
+    for f in inputs:
+        if not os.path.exists(f):
+            return None
+        h.update(f.encode())
+        h.update(FileHash(f, state).encode())
+    return h.hexdigest()
+
+def UpToDate(name, key, state):
+    entry = state["stages"].get(name)
+    if not entry or entry["key"] != key:
+        return False
+    for f in STAGES[name][3]:
+        if not os.path.exists(f) or FileHash(f, state) != entry["outputs"].get(f):
+            return False
+    return True
+
+def Restore(name, key, state):
+    """Copy outputs of an earlier run with the same key from the cache"""
+    keydir = os.path.join(CACHEDIR, key)
+    outputs = STAGES[name][3]
+    if not all(os.path.exists(os.path.join(keydir, os.path.basename(f))) for f in outputs):
+        return False
+    for f in outputs:
+        shutil.copy2(os.path.join(keydir, os.path.basename(f)), f)
+    Record(name, key, state, store=False)
+    return True
+
+def Record(name, key, state, store=True):
+    keydir = os.path.join(CACHEDIR, key)
+    hashes = {}
+    for f in STAGES[name][3]:
+        hashes[f] = FileHash(f, state)
+        if store:
+            if not os.path.isdir(keydir):
+                os.makedirs(keydir)
+            shutil.copy2(f, os.path.join(keydir, os.path.basename(f)))
+    state["stages"][name] = {"key": key, "outputs": hashes}
+
+def Launch(name):
+    macro, args, inputs, outputs = STAGES[name]
+    log = open(os.path.join(CACHEDIR, name + ".log"), "w")
+    cmd = ["root", "-l", "-b", "-q", "%s(%s)" % (macro, args)]
+    return subprocess.Popen(cmd, stdout=log, stderr=subprocess.STDOUT), time.time()
+
+def Pipeline():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("stages", nargs="*", help="targets, all stages by default")
+    parser.add_argument("-j", "--jobs", type=int, default=1, help="number of parallel stages")
+    parser.add_argument("-n", "--dry-run", action="store_true", help="only print what would run")
+    parser.add_argument("-f", "--force", action="append", default=[], help="rerun this stage")
+    args = parser.parse_args()
+
+    for name in args.stages + args.force:
+        if name not in STAGES:
+            print("Unknown stage %s, known stages: %s" % (name, " ".join(sorted(STAGES))))
+            return 1
+
+    if not os.path.isdir(CACHEDIR):
+        os.makedirs(CACHEDIR)
+    state = {"files": {}, "stages": {}}
+    if os.path.exists(STATEFILE):
+        state = json.load(open(STATEFILE))
+
+    producer = Producers()
+    deps = dict((name, Dependencies(name, producer)) for name in STAGES)
+
+    # Targets and everything they depend on
+    todo = set()
+    stack = list(args.stages or STAGES)
+    while stack:
+        name = stack.pop()
+        if name not in todo:
+            todo.add(name)
+            stack += deps[name]
+
+    jobs = max(args.jobs, 1)
+    done = set()
+    rerun = set()
+    failed = set()
+    running = {}
+    status = 0
+    while todo or running:
+        # Finished stages
+        for name, (proc, start) in list(running.items()):
+            if proc.poll() is None:
+                continue
+            del running[name]
+            outputs = STAGES[name][3]
+            ok = proc.returncode == 0 and all(
+                os.path.exists(f) and os.path.getmtime(f) >= start - 1 for f in outputs)
+            if ok:
+                Record(name, StageKey(name, state), state)
+                done.add(name)
+                print("%-20s done in %.0f s" % (name, time.time() - start))
+            else:
+                failed.add(name)
+                status = 1
+                print("%-20s FAILED, see %s/%s.log" % (name, CACHEDIR, name))
+            json.dump(state, open(STATEFILE, "w"), indent=1)
+
+        # Stages with all dependencies done
+        for name in sorted(todo):
+            if any(d in failed for d in deps[name]):
+                todo.discard(name)
+                failed.add(name)
+                print("%-20s skipped, dependency failed" % name)
+                continue
+            if not all(d in done for d in deps[name]):
+                continue
+            if args.dry_run or len(running) < jobs:
+                todo.discard(name)
+                if args.dry_run and any(d in rerun for d in deps[name]):
+                    done.add(name)
+                    rerun.add(name)
+                    print("%-20s would run %s(%s)" % (name, STAGES[name][0], STAGES[name][1]))
+                    continue
+                key = StageKey(name, state)
+                if key is None:
+                    failed.add(name)
+                    status = 1
+                    print("%-20s missing input" % name)
+                elif name not in args.force and UpToDate(name, key, state):
+                    done.add(name)
+                    print("%-20s up to date" % name)
+                elif name not in args.force and not args.dry_run and Restore(name, key, state):
+                    done.add(name)
+                    print("%-20s restored from cache" % name)
+                elif args.dry_run:
+                    done.add(name)
+                    rerun.add(name)
+                    print("%-20s would run %s(%s)" % (name, STAGES[name][0], STAGES[name][1]))
+                else:
+                    running[name] = Launch(name)
+                    print("%-20s started" % name)
+
+        if running:
+            time.sleep(1)
+
+    if not args.dry_run:
+        json.dump(state, open(STATEFILE, "w"), indent=1)
+    return status
+
+if __name__ == "__main__":
+    sys.exit(Pipeline())
@@ -0,0 +1,253 @@
+#!/usr/bin/python
+# Render the plotting macros of a manifest in parallel batch ROOT sessions.
+#
+# Each line of the manifest is a macro with its arguments, e.g.
+#   draw_SysErr.C 0,0,1
+# optionally followed by output=file,... for the files it writes and
+# after=name,... for macros it has to wait for, e.g.
+#   draw_ERTEff_Photon.C 1 output=data/ERTEff-isophoton.root
+# Lines starting with # are comments. Every macro runs through Render.C in
+# its own "root -l -b -q" session, so its globals and canvases do not clash
+# with other macros. Input files named in the macros (new TFile("...") and
+# QueryTree("...") without "RECREATE") are read once before the workers start,
+# so the parallel sessions read them from the page cache and not all from the
+# shared disk at once. A macro reading a file written by another macro of the
+# manifest waits for it, names built with Form("...%s...") are matched as
+# globs, output= replaces these globs by the actual files of the arguments.
+# Macros writing the same file never run at the same time. The slowest macros
+# of the last run start first.
+#
+# Usage: ./Render.py [-j 8] [-m render.list] [--png] [-n] [macro ...]
+# Logs are in data/.render/<name>.log, timings of the last run in
+# data/.render/times.json.
+
+from __future__ import print_function
+
+import argparse
+import fnmatch
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+RENDERDIR = "data/.render"
+TIMESFILE = RENDERDIR + "/times.json"
+
+OPEN_RE = re.compile(r'(?:TFile|QueryTree)\s*\(')
+FORMAT_RE = re.compile(r'%[-+ #0-9.]*[a-zA-Z]')
+ANNOTATION_RE = re.compile(r'^(output|after)=(.*)$')
+
+def ReadManifest(fname):
+    """List of (name, macro, args, annotations) in manifest order"""
+    jobs = []
+    for line in open(fname):
+        line = line.split("#")[0].strip()
+        if not line:
+            continue
+        items = line.split()
+        macro = items[0]
+        annotations = {"output": [], "after": []}
+        args = ""
+        for item in items[1:]:
+            m = ANNOTATION_RE.match(item)
+            if m:
+                annotations[m.group(1)] += [v for v in m.group(2).split(",") if v]
+            else:
+                args += item
+        name = re.sub(r"^draw_|\.C$", "", macro)
+        if args:
+            name += "-" + re.sub(r"[^A-Za-z0-9]+", "-", args).strip("-")
+        jobs.append((name, macro, args, annotations))
+    return jobs
+
+def Arguments(text, pos):
+    """Top level arguments of the call whose ( is just before pos"""
+    args = []
+    depth = 0
+    start = pos
+    quote = None
+    while pos < len(text):
+        c = text[pos]
+        if quote:
+            if c == "\\":
+                pos += 1
+            elif c == quote:
+                quote = None
+        elif c in "\"'":
+            quote = c
+        elif c in "([{":
+            depth += 1
+        elif c in ")]}" and depth > 0:
+            depth -= 1
+        elif c in ",)" and depth == 0:
+            args.append(text[start:pos].strip())
+            if c == ")":
+                break
+            start = pos + 1
+        pos += 1
+    return args
+
+def FileName(arg):
+    """File name of a "..." or Form("...", ...) argument, formats become *"""
+    m = re.match(r'Form\s*\(\s*("[^"]*")', arg)
+    if m:
+        return FORMAT_RE.sub("*", m.group(1)[1:-1])
+    m = re.match(r'"([^"]*)"$', arg)
+    return m.group(1) if m else None
+
+def Overlap(a, b):
+    """Whether file names or globs a and b can be the same file"""
+    return a == b or fnmatch.fnmatchcase(a, b) or fnmatch.fnmatchcase(b, a)
+
+def Files(macro, found=None):
+    """Input and output root files named in a macro and its local headers"""
+    if found is None:
+        found = ([], [], [])
+    inputs, outputs, sources = found
+    sources.append(macro)
+    text = open(macro).read()
+    for m in OPEN_RE.finditer(text):
+        args = Arguments(text, m.end())
+        fname = FileName(args[0]) if args else None
+        if not fname or not fname.endswith(".root"):
+            continue
+        mode = FileName(args[1]) if len(args) > 1 else ""
+        mode = (mode or "").upper()
+        if mode in ("RECREATE", "NEW", "CREATE"):
+            if fname not in outputs:
+                outputs.append(fname)
+        elif mode in ("", "READ") and fname not in inputs:
+            inputs.append(fname)
+    for header in re.findall(r'^\s*#include\s+"([^"]+)"', text, re.M):
+        if header not in sources and os.path.exists(header):
+            Files(header, found)
+    return found
+
+def Warm(files):
+    """Read each file once so the workers find it in the page cache"""
+    start = time.time()
+    size = 0
+    for fname in files:
+        if not os.path.exists(fname):
+            continue
+        with open(fname, "rb") as f:
+            for block in iter(lambda: f.read(1 << 24), b""):
+                size += len(block)
+    print("Read %d input files, %.1f GB in %.0f s" % (len(files), size / 1e9, time.time() - start))
+
+def Launch(name, macro, args, formats):
+    log = open(os.path.join(RENDERDIR, name + ".log"), "w")
+    call = '%s(%s)' % (macro, args)
+    cmd = ["root", "-l", "-b", "-q",
+            'Render.C("%s","%s","%s")' % (call.replace('"', '\\"'), name, formats)]
+    return subprocess.Popen(cmd, stdout=log, stderr=subprocess.STDOUT), time.time()
+
+def Render():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("macros", nargs="*", help="only these macros of the manifest")
+    parser.add_argument("-j", "--jobs", type=int, default=4, help="number of parallel ROOT sessions")
+    parser.add_argument("-m", "--manifest", default="render.list", help="list of macros and arguments")
+    parser.add_argument("--png", action="store_true", help="also print open canvases as PNG")
+    parser.add_argument("--no-warm", action="store_true", help="do not read the inputs beforehand")
+    parser.add_argument("-n", "--dry-run", action="store_true", help="only print what would run")
+    args = parser.parse_args()
+
+    jobs = ReadManifest(args.manifest)
+    if args.macros:
+        jobs = [job for job in jobs if job[1] in args.macros or job[0] in args.macros]
+    if not jobs:
+        print("No macros to render")
+        return 1
+
+    for d in (RENDERDIR, "plots"):
+        if not os.path.isdir(d):
+            os.makedirs(d)
+    times = {}
+    if os.path.exists(TIMESFILE):
+        times = json.load(open(TIMESFILE))
+
+    # A macro reading a file written by another macro waits for it
+    files = dict((name, Files(macro)) for name, macro, margs, notes in jobs)
+    outputs = {}
+    for name, macro, margs, notes in jobs:
+        outputs[name] = files[name][1]
+        if notes["output"]:
+            outputs[name] = [f for f in outputs[name] if "*" not in f] + notes["output"]
+    deps = {}
+    writers = {}
+    for name, macro, margs, notes in jobs:
+        deps[name] = set(other for other, m, a, n in jobs if other != name and
+                (other in notes["after"] or m in notes["after"] or
+                any(Overlap(f, out) for f in files[name][0] for out in outputs[other])))
+        writers[name] = set(other for other, m, a, n in jobs if other != name and
+                any(Overlap(f, out) for f in outputs[name] for out in outputs[other]))
+
+    inputs = sorted(set(f for name in files for f in files[name][0] if "*" not in f and
+            not any(Overlap(f, out) for other in outputs for out in outputs[other])))
+    if args.dry_run:
+        for name, macro, margs, notes in jobs:
+            after = " after " + " ".join(sorted(deps[name])) if deps[name] else ""
+            print("%-30s %s(%s)%s" % (name, macro, margs, after))
+        print("%d input files" % len(inputs))
+        return 0
+    if not args.no_warm:
+        Warm(inputs)
+
+    formats = "png" if args.png else ""
+    macro = dict((name, (m, margs)) for name, m, margs, notes in jobs)
+    todo = sorted(macro, key=lambda name: -times.get(name, 0.))
+    njobs = max(args.jobs, 1)
+    done = set()
+    failed = set()
+    running = {}
+    status = 0
+    start = time.time()
+    while todo or running:
+        for name, (proc, tstart) in list(running.items()):
+            if proc.poll() is None:
+                continue
+            del running[name]
+            if proc.returncode == 0:
+                times[name] = time.time() - tstart
+                done.add(name)
+                print("%-30s done in %.0f s" % (name, times[name]))
+            else:
+                failed.add(name)
+                status = 1
+                print("%-30s FAILED, see %s/%s.log" % (name, RENDERDIR, name))
+
+        for name in list(todo):
+            if deps[name] & failed:
+                todo.remove(name)
+                failed.add(name)
+                print("%-30s skipped, input macro failed" % name)
+                continue
+            # Macros writing the same file run one after the other
+            if len(running) < njobs and deps[name] <= done and not writers[name] & set(running):
+                todo.remove(name)
+                running[name] = Launch(name, macro[name][0], macro[name][1], formats)
+
+        if running:
+            time.sleep(0.5)
+        elif todo:
+            # Macros reading each other's outputs
+            for name in todo:
+                failed.add(name)
+                print("%-30s skipped, circular inputs with %s" % (name, " ".join(sorted(deps[name]))))
+            todo = []
+            status = 1
+
+    json.dump(times, open(TIMESFILE, "w"), indent=1, sort_keys=True)
+
+    # Summary, slowest first
+    print("\n%-30s %8s" % ("macro", "time (s)"))
+    for name in sorted(done, key=lambda name: -times[name]):
+        print("%-30s %8.1f" % (name, times[name]))
+    print("%d rendered, %d failed in %.0f s wall, %.0f s in ROOT" %
+            (len(done), len(failed), time.time() - start, sum(times[name] for name in done)))
+    return status
+
+if __name__ == "__main__":
+    sys.exit(Render())
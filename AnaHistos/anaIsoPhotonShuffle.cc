@@ -14,6 +14,7 @@
 #include <TGraphErrors.h>
 
 #include "CommonFunc.h"
+#include "PhotonBunch.h"
 
 using namespace std;
 
@@ -151,6 +152,14 @@ int main(int argc, char *argv[])
     int checkmap = 1;
     int beam = 2;
 
+    PhotonBunch photon_bunch(f, checkmap, ical);
+    if( !photon_bunch.IsValid() )
+    {
+      cout << "No bunch yields for runnumber = " << runnumber << endl;
+      delete f;
+      continue;
+    }
+
     double nphoton[6][2][2][npT_pol] = {};  // imul, icr, ipol, ipt
     for(int imul=0; imul<6; imul++)
       for(int icr=0; icr<2; icr++)
@@ -158,10 +167,8 @@ int main(int argc, char *argv[])
           if(abs(spin_pol[icr + 2*ib]) == 1)
           {
             int ipol = spin_rnd[icr + 2*ib];
-            int ih = imul + 6*icr + 6*2*ib + 6*2*60*checkmap + 6*2*60*2*ical;
-            TH1 *h_photon_bunch = (TH1*)f->Get(Form("h_photon_bunch_%d",ih));
             for(int ipt=0; ipt<npT_pol; ipt++)
-              nphoton[imul][icr][ipol][ipt] += h_photon_bunch->GetBinContent(ipt+1);
+              nphoton[imul][icr][ipol][ipt] += photon_bunch.Get(imul, icr, ib, ipt);
           } // icr, ib, imul
     for(int icr=0; icr<2; icr++)
       for(int ipol=0; ipol<2; ipol++)
@@ -5,6 +5,8 @@
 #include <TTree.h>
 #include <TH1.h>
 
+#include "PhotonBunch.h"
+
 using namespace std;
 
 int main()
@@ -43,15 +45,21 @@ int main()
     int ical = 0;  // Use Sasha's calibration
     int isolated = 1;  // isolated photons
     int checkmap = 1;  // Use DC deadmap
+    PhotonBunch photon_bunch(f, checkmap, ical);
+    if( !photon_bunch.IsValid() )
+    {
+      cout << "No bunch yields for runnumber = " << runnumber << endl;
+      delete f;
+      continue;
+    }
+
     for(int icr=0; icr<2; icr++)
       for(int ib=0; ib<60; ib++)
       {
         crossing = icr + 2*ib;  // crossing ID in spin database
-        int ih = isolated + 6*icr + 6*2*ib + 6*2*60*checkmap + 6*2*60*2*ical;
-        TH1 *h_pt = (TH1*)f->Get(Form("h_photon_bunch_%d",ih));
         for(ipt=0; ipt<npT_pol; ipt++)
         {
-          yield = h_pt->GetBinContent(ipt+1);
+          yield = photon_bunch.Get(isolated, icr, ib, ipt);
           t_yield->Fill();
         } // ipt
       } // icr, ib
@@ -7,6 +7,8 @@
 #include <TTree.h>
 #include <TH1.h>
 
+#include "PhotonBunch.h"
+
 using namespace std;
 
 bool valid_bunch(int bunch, int spin_pol[])
@@ -108,6 +110,14 @@ int main()
     int checkmap = 1;
     int beam = 2;
 
+    PhotonBunch photon_bunch(f, checkmap, ical);
+    if( !photon_bunch.IsValid() )
+    {
+      cout << "No bunch yields for runnumber = " << runnumber << endl;
+      delete f;
+      continue;
+    }
+
     double nphoton[6][2][2][npT_pol] = {};  // imul, icr, ipol, ipt
     for(int imul=0; imul<6; imul++)
       for(int icr=0; icr<2; icr++)
@@ -116,10 +126,8 @@ int main()
           if(valid_bunch(icr + 2*ib,spin_pol))
           {
             int ipol = spin_pol[icr + 2*ib] > 0 ? 1 : 0;
-            int ih = imul + 6*icr + 6*2*ib + 6*2*60*checkmap + 6*2*60*2*ical;
-            TH1 *h_photon_bunch = (TH1*)f->Get(Form("h_photon_bunch_%d",ih));
             for(int ipt=0; ipt<npT_pol; ipt++)
-              nphoton[imul][icr][ipol][ipt] += h_photon_bunch->GetBinContent(ipt+1);
+              nphoton[imul][icr][ipol][ipt] += photon_bunch.Get(imul, icr, ib, ipt);
           } // icr, ib, imul
     for(int icr=0; icr<2; icr++)
       for(int ipol=0; ipol<2; ipol++)
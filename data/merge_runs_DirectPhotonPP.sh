@@ -40,26 +40,19 @@ for DATASET in $DATASETS; do
 
     echo "Merging $NRUNS files from input directory $INPUT_DIR to $OUTPUT_FILE ... "
 
-    ## LIMIT hadd to 1000 files at a time because of "Too many open files" error
-    if [[ $NRUNS -le 1000 ]]; then
-
-	for RUN in $RUNLIST; do
-#	    if [[ $ALLOW_SKIP_RUNS="true" ]]; then
-#		if [[ -e $INPUT_DIR/DirectPhotonPP-${RUN}.root ]]; then
-#		    echo "$INPUT_DIR/DirectPhotonPP-${RUN}.root" >> $TEMPFILE
-#		fi
-#	    else
-		echo "$INPUT_DIR/DirectPhotonPP-${RUN}.root" >> $TEMPFILE
+    for RUN in $RUNLIST; do
+#	if [[ $ALLOW_SKIP_RUNS="true" ]]; then
+#	    if [[ -e $INPUT_DIR/DirectPhotonPP-${RUN}.root ]]; then
+#		echo "$INPUT_DIR/DirectPhotonPP-${RUN}.root" >> $TEMPFILE
 #	    fi
-	done
-
-	FILELIST=("${(@f)$(cat $TEMPFILE)}")
-	echo $FILELIST
-	hadd $OUTPUT_FILE $FILELIST
-    else
-	echo "More than 1000 runs, stop processing. ERROR."
-	exit
-    fi
+#	else
+	    echo "$INPUT_DIR/DirectPhotonPP-${RUN}.root" >> $TEMPFILE
+#	fi
+    done
+
+    ## mergeHistos reads one file at a time, no limit on the number of runs;
+    ## add -a to append new runs to an existing output
+    mergeHistos -j 8 -l $TEMPFILE $OUTPUT_FILE || exit
 
     echo "DONE."
 
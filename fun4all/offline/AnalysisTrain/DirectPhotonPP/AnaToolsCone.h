@@ -0,0 +1,94 @@
+#ifndef __ANATOOLSCONE_H__
+#define __ANATOOLSCONE_H__
+
+#include <TMath.h>
+#include <TVector2.h>
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <cassert>
+
+/*! Namespace with various functions for analysis.
+ * This file provides isolation cone sums for several cone radii at once
+ */
+namespace anatools
+{
+  /*!
+   * Distance in eta-phi space, with phi difference wrapped into [-pi, pi]
+   */
+  inline double GetConeDistance(const TVector2 &v2_pref, const TVector2 &v2_part)
+  {
+    TVector2 v2_diff(v2_part - v2_pref);
+    if( v2_diff.Y() > TMath::Pi() ) v2_diff -= TVector2(0., 2.*TMath::Pi());
+    else if( v2_diff.Y() < -TMath::Pi() ) v2_diff += TVector2(0., 2.*TMath::Pi());
+
+    return v2_diff.Mod();
+  }
+
+  /*!
+   * Cumulative sums within isolation cones of several radii.
+   * Add each neighbour with its distance to the reference particle and the
+   * index of the sum it contributes to (e.g. EMCal energy, EMCal energy with
+   * charge veto, track momentum). Compute() sorts the neighbours by distance
+   * and prefix-sums them, so all radii cost about as much as a single cone.
+   * A neighbour is inside a cone if its distance is smaller than the radius.
+   * The radii must be in ascending order, so Get() uses the caller's indices.
+   */
+  class ConeSums
+  {
+    public:
+      ConeSums(const std::vector<double> &a_radii, unsigned a_nsum = 1):
+        radii(a_radii), nsum(a_nsum), sums(a_radii.size()*a_nsum, 0.)
+      {
+        assert( std::adjacent_find(radii.begin(), radii.end(), std::greater<double>()) == radii.end() );
+      }
+
+      /* Radii in the order given, the index used by Get() */
+      const std::vector<double>& GetRadii() const { return radii; }
+
+      void Clear() { neighbours.clear(); }
+
+      void Add(double dr, double weight, unsigned isum = 0)
+      {
+        if( radii.empty() || dr >= radii.back() ) return;
+        neighbours.push_back( Neighbour(dr, weight, isum) );
+      }
+
+      void Compute()
+      {
+        std::sort(neighbours.begin(), neighbours.end());
+
+        std::vector<double> cumsum(nsum, 0.);
+        unsigned in = 0;
+        for(unsigned ir=0; ir<radii.size(); ir++)
+        {
+          for(; in<neighbours.size() && neighbours[in].dr < radii[ir]; in++)
+            cumsum[neighbours[in].isum] += neighbours[in].weight;
+          for(unsigned isum=0; isum<nsum; isum++)
+            sums[ir + radii.size()*isum] = cumsum[isum];
+        }
+      }
+
+      double Get(unsigned ir, unsigned isum = 0) const { return sums[ir + radii.size()*isum]; }
+
+    protected:
+      struct Neighbour
+      {
+        double dr;
+        double weight;
+        unsigned isum;
+
+        Neighbour(double a_dr, double a_weight, unsigned a_isum):
+          dr(a_dr), weight(a_weight), isum(a_isum) {}
+        bool operator<(const Neighbour &other) const { return dr < other.dr; }
+      };
+
+      std::vector<double> radii;
+      unsigned nsum;
+      std::vector<double> sums;
+      std::vector<Neighbour> neighbours;
+  };
+}
+
+#endif /* __ANATOOLSCONE_H__ */
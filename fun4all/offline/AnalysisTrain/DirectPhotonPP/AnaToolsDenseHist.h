@@ -0,0 +1,148 @@
+#ifndef __ANATOOLSDENSEHIST_H__
+#define __ANATOOLSDENSEHIST_H__
+
+#include <THnBase.h>
+#include <TAxis.h>
+#include <TArrayD.h>
+
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+
+/*! Namespace with various functions for analysis.
+ * This file provides a dense fill buffer for THnSparse/THn histograms
+ */
+namespace anatools
+{
+  /*!
+   * Dense N-dimensional histogram with the binning of a booked THnBase.
+   * Init() copies the axes of the target histogram, including variable bin
+   * edges, and allocates sum(w) and sum(w^2) for every bin with under- and
+   * overflow, so Fill() is a bin search per axis and one multiply-add per
+   * dimension instead of a hash lookup. Flush() adds the filled bins to
+   * the target, e.g. in End() before scaling or writing, sets its number
+   * of entries and clears the buffer.
+   * Only use it for tables whose full size fits in memory, typically a
+   * truth/reco pT pair times a few small categorical axes. The sum of
+   * weights statistics of THnBase (GetMean, GetRMS) are not filled.
+   */
+  template<int N>
+  class DenseHist
+  {
+    public:
+      DenseHist(): hn(0), nentries(0) {}
+
+      void Init(THnBase *a_hn)
+      {
+        if( a_hn->GetNdimensions() != N )
+        {
+          std::cerr << "DenseHist: " << a_hn->GetName() << " has " << a_hn->GetNdimensions()
+            << " dimensions, expected " << N << std::endl;
+          exit(1);
+        }
+
+        hn = a_hn;
+        Long64_t size = 1;
+        for(int i=N-1; i>=0; i--)
+        {
+          const TAxis *axis = hn->GetAxis(i);
+          nbins[i] = axis->GetNbins();
+          xmin[i] = axis->GetXmin();
+          xmax[i] = axis->GetXmax();
+          edges[i].clear();
+          if( axis->GetXbins()->GetSize() > 0 )
+            edges[i].assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + nbins[i] + 1);
+          stride[i] = size;
+          size *= nbins[i] + 2;
+        }
+
+        sumw.assign(size, 0.);
+        sumw2.clear();
+        if( hn->GetCalculateErrors() )
+          sumw2.assign(size, 0.);
+        touched.assign(size, false);
+        filled.clear();
+        nentries = 0;
+      }
+
+      bool IsInit() const { return hn != 0; }
+      THnBase* GetHist() const { return hn; }
+
+      /* Bin on axis i as given by TAxis::FindBin(), 0 is underflow and nbins+1 overflow */
+      int FindBin(int i, double x) const
+      {
+        if( !(x >= xmin[i]) ) return 0;
+        if( x >= xmax[i] ) return nbins[i] + 1;
+        if( edges[i].empty() )
+          return 1 + (int)( nbins[i] * (x - xmin[i]) / (xmax[i] - xmin[i]) );
+        return std::upper_bound(edges[i].begin(), edges[i].end(), x) - edges[i].begin();
+      }
+
+      void Fill(const double *x, double w = 1.)
+      {
+        Long64_t ib = 0;
+        for(int i=0; i<N; i++)
+          ib += stride[i] * FindBin(i, x[i]);
+        if( !touched[ib] )
+        {
+          touched[ib] = true;
+          filled.push_back(ib);
+        }
+        sumw[ib] += w;
+        if( !sumw2.empty() )
+          sumw2[ib] += w*w;
+        nentries++;
+      }
+
+      /* Add the filled bins to the target histogram and clear the buffer.
+       * AddBinContent() does not count entries, so they are set here. */
+      void Flush()
+      {
+        if( !hn ) return;
+
+        Int_t idx[N];
+        for(unsigned k=0; k<filled.size(); k++)
+        {
+          Long64_t ib = filled[k];
+          for(int i=0; i<N; i++)
+            idx[i] = ( ib / stride[i] ) % ( nbins[i] + 2 );
+
+          Long64_t bin = hn->GetBin(idx, kTRUE);
+          hn->AddBinContent(bin, sumw[ib]);
+          sumw[ib] = 0.;
+          if( !sumw2.empty() )
+          {
+            hn->AddBinError2(bin, sumw2[ib]);
+            sumw2[ib] = 0.;
+          }
+          touched[ib] = false;
+        }
+        hn->SetEntries(hn->GetEntries() + nentries);
+
+        filled.clear();
+        nentries = 0;
+      }
+
+    protected:
+      THnBase *hn;
+
+      int nbins[N];
+      double xmin[N];
+      double xmax[N];
+      std::vector<double> edges[N];
+      Long64_t stride[N];
+
+      std::vector<double> sumw;
+      std::vector<double> sumw2;
+      std::vector<bool> touched;
+      std::vector<Long64_t> filled;
+      Long64_t nentries;
+
+    private:
+      DenseHist(const DenseHist&);
+      DenseHist& operator=(const DenseHist&);
+  };
+}
+
+#endif /* __ANATOOLSDENSEHIST_H__ */
@@ -0,0 +1,157 @@
+#ifndef __ANATOOLSGEOMETRY_H__
+#define __ANATOOLSGEOMETRY_H__
+
+#include <TMath.h>
+#include <TVector2.h>
+#include <TVector3.h>
+
+#include <vector>
+
+/*! Namespace with various functions for analysis.
+ * This file provides lookup tables for the ideal EMCal geometry.
+ */
+namespace anatools
+{
+  /*!
+   * Ideal EMCal geometry with tables for all towers, shared by all modules.
+   * The tables are filled once on the first call of Instance().
+   *
+   * Sector counting scheme as in AnaToolsTowerID.h: sectors 0 - 3 are W0 - W3,
+   * sectors 4 - 7 are E3 - E0, sectors 6 - 7 are PbGl. Tower ID's are the same
+   * as from TowerID(). In the sector frame the X axis points from the vertex to
+   * the sector centre, Y and Z count along the tower rows; on the East arm
+   * Y and Z are reversed with respect to the global frame.
+   */
+  class EmcGeometry
+  {
+    public:
+      static const int nsector = 8;
+      static const int ntower = 24768;
+      static const int maxneighbour = 8;
+
+      static const EmcGeometry& Instance()
+      {
+        static const EmcGeometry geom;
+        return geom;
+      }
+
+      /* Sector properties */
+      int GetNY(int sec) const { return sec < 6 ? 36 : 48; }
+      int GetNZ(int sec) const { return sec < 6 ? 72 : 96; }
+      int GetFirstTower(int sec) const { return sec < 6 ? sec*2592 : 15552 + (sec-6)*4608; }
+      double GetPhiSector(int sec) const { return phi_sec[sec]; }
+      double GetRadius(int sec) const { return sec < 6 ? 507. : 540.; }
+      double GetYSize(int sec) const { return sec < 6 ? 5.57 : 4.106; }
+      double GetZSize(int sec) const { return sec < 6 ? 5.58 : 4.092; }
+
+      /* Tower ID from location, -1 if the tower does not exist */
+      int GetTowerID(int sec, int iy, int iz) const
+      {
+        if( sec < 0 || sec >= nsector || iy < 0 || iy >= GetNY(sec) || iz < 0 || iz >= GetNZ(sec) )
+          return -1;
+        return GetFirstTower(sec) + iy*GetNZ(sec) + iz;
+      }
+
+      /* Tower location and properties from tower ID */
+      int GetSector(int itower) const { return tower_sec[itower]; }
+      int GetY(int itower) const { return tower_y[itower]; }
+      int GetZ(int itower) const { return tower_z[itower]; }
+      int GetSM(int itower) const { return tower_sm[itower]; }
+      const TVector3& GetCenter(int itower) const { return tower_center[itower]; }
+      double GetEta(int itower) const { return tower_eta[itower]; }
+      double GetPhi(int itower) const { return tower_phi[itower]; }
+
+      /* Towers of the 3x3 matrix around a tower, without the tower itself.
+       * Only towers in the same sector are neighbours. */
+      int GetNNeighbour(int itower) const { return n_neighbour[itower]; }
+      int GetNeighbour(int itower, int i) const { return neighbour[itower*maxneighbour + i]; }
+
+      /* Sector with |phi - phi_sec| < pi/16, -1 if outside */
+      int FindSector(double phi) const
+      {
+        for(int is=0; is<nsector; is++)
+        {
+          double dphi = TVector2::Phi_mpi_pi(phi - phi_sec[is]);
+          if( TMath::Abs(dphi) < TMath::Pi()/16. ) return is;
+        }
+        return -1;
+      }
+
+      /* Rotate from global into sector frame and back */
+      TVector3 ToSectorFrame(int sec, const TVector3 &v3) const
+      {
+        TVector3 v3_sec(v3);
+        v3_sec.RotateZ(-phi_sec[sec]);
+        if( sec >= 4 ) v3_sec.SetXYZ(v3_sec.X(), -v3_sec.Y(), -v3_sec.Z());
+        return v3_sec;
+      }
+      TVector3 FromSectorFrame(int sec, const TVector3 &v3_sec) const
+      {
+        TVector3 v3(v3_sec);
+        if( sec >= 4 ) v3.SetXYZ(v3.X(), -v3.Y(), -v3.Z());
+        v3.RotateZ(phi_sec[sec]);
+        return v3;
+      }
+
+    protected:
+      EmcGeometry():
+        tower_sec(ntower), tower_y(ntower), tower_z(ntower), tower_sm(ntower),
+        tower_center(ntower), tower_eta(ntower), tower_phi(ntower),
+        n_neighbour(ntower, 0), neighbour(ntower*maxneighbour, -1)
+      {
+        const double PI = TMath::Pi();
+        const double phi[nsector] = {
+          -PI/8, 0, PI/8, 2*PI/8,
+          PI-2*PI/8, PI-PI/8, PI, PI+PI/8
+        };
+
+        for(int sec=0; sec<nsector; sec++)
+        {
+          phi_sec[sec] = phi[sec];
+
+          int nY = GetNY(sec);
+          int nZ = GetNZ(sec);
+          for(int iy=0; iy<nY; iy++)
+            for(int iz=0; iz<nZ; iz++)
+            {
+              int itower = GetTowerID(sec, iy, iz);
+              tower_sec[itower] = sec;
+              tower_y[itower] = iy;
+              tower_z[itower] = iz;
+              tower_sm[itower] = sec < 6 ? iy/12*6 + iz/12 : iy/12*8 + iz/12;
+
+              TVector3 v3_sec( GetRadius(sec),
+                  (iy + 0.5 - nY/2.) * GetYSize(sec),
+                  (iz + 0.5 - nZ/2.) * GetZSize(sec) );
+              tower_center[itower] = FromSectorFrame(sec, v3_sec);
+              tower_eta[itower] = tower_center[itower].Eta();
+              tower_phi[itower] = tower_center[itower].Phi();
+
+              for(int dy=-1; dy<=1; dy++)
+                for(int dz=-1; dz<=1; dz++)
+                {
+                  int inb = GetTowerID(sec, iy+dy, iz+dz);
+                  if( inb < 0 || inb == itower ) continue;
+                  neighbour[itower*maxneighbour + n_neighbour[itower]] = inb;
+                  n_neighbour[itower]++;
+                }
+            }
+        }
+      }
+
+      double phi_sec[nsector];
+
+      std::vector<int> tower_sec;
+      std::vector<int> tower_y;
+      std::vector<int> tower_z;
+      std::vector<int> tower_sm;
+      std::vector<TVector3> tower_center;
+      std::vector<double> tower_eta;
+      std::vector<double> tower_phi;
+
+      std::vector<int> n_neighbour;
+      std::vector<int> neighbour;
+  };
+}
+
+#endif /* __ANATOOLSGEOMETRY_H__ */
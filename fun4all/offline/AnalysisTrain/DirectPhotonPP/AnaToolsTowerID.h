@@ -1,6 +1,10 @@
 #ifndef __ANATOOLSTOWERID_H__
 #define __ANATOOLSTOWERID_H__
 
+#ifndef __CINT__
+#include "AnaToolsGeometry.h"
+#endif
+
 #include <iostream>
 
 /*! Namespace with various functions for analysis.
@@ -56,9 +60,23 @@ namespace anatools
 
 
   /*! calculate sector, yrow, and zrow location of tower for given tower ID
+   *
+   * Compiled code looks valid IDs up in the EmcGeometry tables instead of
+   * dividing, other IDs and interpreted macros use the arithmetic.
   */
   inline void TowerLocation( const unsigned int towerid, int &sector, int &ytower, int &ztower )
   {
+#ifndef __CINT__
+    if( towerid < (unsigned int)EmcGeometry::ntower )
+    {
+      const EmcGeometry &geom = EmcGeometry::Instance();
+      sector = geom.GetSector( towerid );
+      ytower = geom.GetY( towerid );
+      ztower = geom.GetZ( towerid );
+      return;
+    }
+#endif
+
     int itower=0;
 
     if( towerid < 15552 )
@@ -0,0 +1,92 @@
+#ifndef __ANATOOLSTREECOLUMNS_H__
+#define __ANATOOLSTREECOLUMNS_H__
+
+#include <TTree.h>
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <iostream>
+#include <cstdlib>
+
+/*! Namespace with various functions for analysis.
+ * This file provides typed output columns for flat trees
+ */
+namespace anatools
+{
+  /*!
+   * Set of float output columns for TTrees, declared once in Init().
+   * Scalar columns hold one value per event, vector columns one value per
+   * particle or cluster. Add*() returns the handle used by Set()/Push(),
+   * handles of each kind count up from 0 in declaration order, so columns
+   * declared in a row can be addressed as first handle + offset. Branch()
+   * adds all columns to a tree, a set can be branched to several trees.
+   * No column can be added after Branch(), the buffers must not move.
+   * Reset() sets scalars to NAN and clears vectors, keeping their capacity.
+   */
+  class TreeColumns
+  {
+    public:
+      TreeColumns(): branched(false) {}
+
+      int AddScalar(const std::string &name)
+      {
+        CheckNotBranched(name);
+        scalar_names.push_back(name);
+        scalars.push_back( std::numeric_limits<float>::quiet_NaN() );
+        return scalars.size() - 1;
+      }
+
+      int AddVector(const std::string &name)
+      {
+        CheckNotBranched(name);
+        vector_names.push_back(name);
+        vectors.push_back( std::vector<float>() );
+        return vectors.size() - 1;
+      }
+
+      void Branch(TTree *tree)
+      {
+        branched = true;
+        for(unsigned i=0; i<scalars.size(); i++)
+          tree->Branch( scalar_names[i].c_str(), &scalars[i] );
+        for(unsigned i=0; i<vectors.size(); i++)
+          tree->Branch( vector_names[i].c_str(), &vectors[i] );
+      }
+
+      void Set(int handle, float value) { scalars[handle] = value; }
+      void Push(int handle, float value) { vectors[handle].push_back(value); }
+
+      void Reset()
+      {
+        for(unsigned i=0; i<scalars.size(); i++)
+          scalars[i] = std::numeric_limits<float>::quiet_NaN();
+        for(unsigned i=0; i<vectors.size(); i++)
+          vectors[i].clear();
+      }
+
+    protected:
+      void CheckNotBranched(const std::string &name) const
+      {
+        if(branched)
+        {
+          std::cerr << "TreeColumns: cannot add column " << name << " after Branch()" << std::endl;
+          exit(1);
+        }
+      }
+
+      bool branched;
+
+      std::vector<std::string> scalar_names;
+      std::vector<float> scalars;
+
+      std::vector<std::string> vector_names;
+      std::vector< std::vector<float> > vectors;
+
+    private:
+      TreeColumns(const TreeColumns&);
+      TreeColumns& operator=(const TreeColumns&);
+  };
+}
+
+#endif /* __ANATOOLSTREECOLUMNS_H__ */
@@ -0,0 +1,296 @@
+#include "ConditionsCache.h"
+
+#include <SpinDBOutput.hh>
+#include <SpinDBContent.hh>
+
+#include <TFile.h>
+#include <TTree.h>
+#include <TDirectory.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <future>
+
+using namespace std;
+
+namespace
+{
+  /* Spin DB result of one run, no ROOT object is created in the query */
+  struct SpinDBQuery
+  {
+    int runnumber;
+    int qa_level;
+    bool spin_ok;
+    SpinDBContent spin_cont;
+  };
+
+  SpinDBQuery QuerySpinDB(int runnumber)
+  {
+    SpinDBQuery query;
+    query.runnumber = runnumber;
+
+    /* Initialize object to access spin DB */
+    SpinDBOutput spin_out;
+    spin_out.Initialize();
+    spin_out.SetUserName("phnxrc");
+    spin_out.SetTableName("spin");
+
+    /* Retrieve entry from Spin DB */
+    query.qa_level = spin_out.GetDefaultQA(runnumber);
+    spin_out.StoreDBContent(runnumber, runnumber, query.qa_level);
+    spin_out.GetDBContentStore(query.spin_cont, runnumber);
+    query.spin_ok = spin_out.CheckRunRow(runnumber, query.qa_level) == 1 &&
+      query.spin_cont.GetRunNumber() == runnumber;
+
+    return query;
+  }
+
+  void FillSpinPattern(SpinDBContent &spin_cont, SpinPattern &spinpattern)
+  {
+    spinpattern.Reset();
+
+    spinpattern.set_runnumber( spin_cont.GetRunNumber() );
+    spinpattern.set_qa_level( spin_cont.GetQALevel() );
+    spinpattern.set_fillnumber( spin_cont.GetFillNumber() );
+    spinpattern.set_badrunqa( spin_cont.GetBadRunFlag() );
+    spinpattern.set_crossing_shift( spin_cont.GetCrossingShift() );
+
+    double pb, pbstat, pbsyst;
+    double py, pystat, pysyst;
+
+    spin_cont.GetPolarizationBlue(1, pb, pbstat, pbsyst);
+    spin_cont.GetPolarizationYellow(1, py, pystat, pysyst);
+
+    spinpattern.set_pb(pb);
+    spinpattern.set_pbstat(pbstat);
+    spinpattern.set_pbsyst(pbsyst);
+    spinpattern.set_py(py);
+    spinpattern.set_pystat(pystat);
+    spinpattern.set_pysyst(pysyst);
+
+    for(int i=0; i<120; i++)
+    {
+      spinpattern.set_badbunch( i, spin_cont.GetBadBunchFlag(i) );
+      spinpattern.set_spinpattern_blue( i, spin_cont.GetSpinPatternBlue(i) );
+      spinpattern.set_spinpattern_yellow( i, spin_cont.GetSpinPatternYellow(i) );
+
+      /* For Run13, GL1p swap narrow and wide.
+       * So I swap narrow and wide to correct the error. */
+      spinpattern.set_bbc_narrow( i, spin_cont.GetScalerBbcNoCut(i) );
+      spinpattern.set_bbc_wide( i, spin_cont.GetScalerBbcVertexCut(i) );
+      spinpattern.set_zdc_narrow( i, spin_cont.GetScalerZdcWide(i) );
+      spinpattern.set_zdc_wide( i, spin_cont.GetScalerZdcNarrow(i) );
+    }
+
+    return;
+  }
+
+  void FillConditions(SpinDBQuery &query, RunConditions &cond)
+  {
+    cond.runnumber = query.runnumber;
+    cond.qa_level = query.qa_level;
+    cond.fillnumber = query.spin_cont.GetFillNumber();
+    cond.spin_ok = query.spin_ok;
+    if(cond.spin_ok)
+      FillSpinPattern(query.spin_cont, cond.spinpattern);
+    else
+      cond.spinpattern.Reset();
+
+    return;
+  }
+}
+
+/* Spin DB query running in the background */
+class ConditionsPrefetch
+{
+  public:
+    int runnumber;
+    future<SpinDBQuery> result;
+};
+
+ConditionsCache* ConditionsCache::instance()
+{
+  /* Destroyed at exit, after waiting for a running prefetch */
+  static ConditionsCache cache;
+  return &cache;
+}
+
+ConditionsCache::ConditionsCache():
+  dbaccess(true),
+  prefetch(nullptr)
+{
+}
+
+ConditionsCache::~ConditionsCache()
+{
+  if(prefetch)
+    prefetch->result.wait();
+  delete prefetch;
+}
+
+void ConditionsCache::ReadSnapshot(const string &filename)
+{
+  TDirectory *olddir = gDirectory;
+  TFile *f = new TFile(filename.c_str());
+  olddir->cd();
+  if( !f->IsOpen() )
+  {
+    cerr << "ConditionsCache: cannot open snapshot " << filename << endl;
+    delete f;
+    exit(1);
+  }
+
+  TTree *t = (TTree*)f->Get("T");
+  if(!t)
+  {
+    cerr << "ConditionsCache: no tree T in snapshot " << filename << endl;
+    delete f;
+    exit(1);
+  }
+
+  RunConditions cond;
+  SpinPattern *spinpattern = nullptr;
+  t->SetBranchAddress("runnumber", &cond.runnumber);
+  t->SetBranchAddress("qa_level", &cond.qa_level);
+  t->SetBranchAddress("fillnumber", &cond.fillnumber);
+  t->SetBranchAddress("spin_ok", &cond.spin_ok);
+  t->SetBranchAddress("spinpattern", &spinpattern);
+
+  Long64_t nentries = t->GetEntries();
+  for(Long64_t i=0; i<nentries; i++)
+  {
+    t->GetEntry(i);
+    cond.spinpattern = *spinpattern;
+    conditions[cond.runnumber] = cond;
+  }
+
+  cout << "ConditionsCache: " << nentries << " runs from " << filename << endl;
+
+  delete spinpattern;
+  delete f;
+  return;
+}
+
+void ConditionsCache::WriteSnapshot(const string &filename) const
+{
+  TDirectory *olddir = gDirectory;
+  TFile *f = new TFile(filename.c_str(), "RECREATE");
+  if( !f->IsOpen() )
+  {
+    cerr << "ConditionsCache: cannot create snapshot " << filename << endl;
+    delete f;
+    olddir->cd();
+    return;
+  }
+
+  RunConditions cond;
+  SpinPattern *spinpattern = &cond.spinpattern;
+  TTree *t = new TTree("T", "Spin DB conditions by run");
+  t->Branch("runnumber", &cond.runnumber, "runnumber/I");
+  t->Branch("qa_level", &cond.qa_level, "qa_level/I");
+  t->Branch("fillnumber", &cond.fillnumber, "fillnumber/I");
+  t->Branch("spin_ok", &cond.spin_ok, "spin_ok/O");
+  t->Branch("spinpattern", &spinpattern);
+
+  for(map<int, RunConditions>::const_iterator it = conditions.begin(); it != conditions.end(); ++it)
+  {
+    cond = it->second;
+    t->Fill();
+  }
+
+  f->cd();
+  t->Write();
+  f->Close();
+  delete f;
+  olddir->cd();
+
+  return;
+}
+
+void ConditionsCache::SetRunList(const vector<int> &runs)
+{
+  runlist = runs;
+
+  /* Query the first run while the job is set up */
+  if( !runlist.empty() )
+    Prefetch(runlist.front());
+
+  return;
+}
+
+void ConditionsCache::ReadRunList(const string &filename)
+{
+  ifstream fin(filename.c_str());
+  if(!fin)
+  {
+    cerr << "ConditionsCache: cannot open run list " << filename << endl;
+    exit(1);
+  }
+
+  vector<int> runs;
+  int run;
+  while( fin >> run )
+    runs.push_back(run);
+
+  SetRunList(runs);
+  return;
+}
+
+const RunConditions& ConditionsCache::Get(int runnumber)
+{
+  /* A running query is waited for even if it is for another run,
+   * its result is kept and no second connection is opened meanwhile */
+  WaitPrefetch();
+
+  if( !IsCached(runnumber) )
+  {
+    if(dbaccess)
+    {
+      SpinDBQuery query = QuerySpinDB(runnumber);
+      FillConditions(query, conditions[runnumber]);
+    }
+    else
+    {
+      /* Fill number -9999 would silently keep the TOF constants of the previous run */
+      cerr << "ConditionsCache: run " << runnumber << " not in snapshot and no DB access" << endl;
+      exit(1);
+    }
+  }
+
+  /* Query the next run while this one is processed */
+  for(unsigned i=0; i+1<runlist.size(); i++)
+    if( runlist[i] == runnumber )
+    {
+      Prefetch(runlist[i+1]);
+      break;
+    }
+
+  return conditions[runnumber];
+}
+
+void ConditionsCache::Prefetch(int runnumber)
+{
+  if( !dbaccess || prefetch || IsCached(runnumber) )
+    return;
+
+  prefetch = new ConditionsPrefetch();
+  prefetch->runnumber = runnumber;
+  prefetch->result = async(launch::async, QuerySpinDB, runnumber);
+
+  return;
+}
+
+void ConditionsCache::WaitPrefetch()
+{
+  if(!prefetch)
+    return;
+
+  /* SpinPattern is a ROOT object, it is only filled in this thread */
+  SpinDBQuery query = prefetch->result.get();
+  FillConditions(query, conditions[query.runnumber]);
+
+  delete prefetch;
+  prefetch = nullptr;
+  return;
+}
@@ -0,0 +1,81 @@
+#ifndef __CONDITIONSCACHE_H__
+#define __CONDITIONSCACHE_H__
+
+#include "SpinPattern.h"
+
+#include <string>
+#include <vector>
+#include <map>
+
+class ConditionsPrefetch;
+
+/* Spin DB conditions of one run as used in InitRun */
+struct RunConditions
+{
+  int runnumber;
+  int qa_level;
+  int fillnumber;
+
+  /* Spin DB has a row for this run at its default QA level */
+  bool spin_ok;
+
+  /* Spin DB content with the Run13 GL1p narrow and wide scalers swapped back,
+   * reset if not spin_ok */
+  SpinPattern spinpattern;
+};
+
+/**
+ * Spin DB conditions of each run, shared by all modules in the job.
+ * A run is queried from the spin DB once and cached, or served from a local
+ * snapshot written with WriteSnapshot(), so jobs can run without DB access.
+ * With a run list the spin DB query of the next run is started in the
+ * background when a run is requested, while the current run is processed.
+ * Recalibration constants come from the local files of EmcLocalRecalibrator
+ * and the DC dead map from DCDeadmapChecker, both only need the run and fill.
+ */
+class ConditionsCache
+{
+  public:
+    static ConditionsCache* instance();
+    virtual ~ConditionsCache();
+
+    /* Add all runs of a snapshot file, exits if it cannot be read */
+    void ReadSnapshot(const std::string &filename);
+
+    /* Write all cached runs to a snapshot file */
+    void WriteSnapshot(const std::string &filename) const;
+
+    /* Runs in processing order, one run number per line in the file */
+    void SetRunList(const std::vector<int> &runs);
+    void ReadRunList(const std::string &filename);
+
+    /* Runs neither cached nor in a snapshot are queried from the spin DB,
+     * without DB access such a run is a fatal error (exit) */
+    void SetDBAccess(bool a_dbaccess = true) { dbaccess = a_dbaccess; }
+
+    /* Conditions of this run, starts the query of the next run in the run list */
+    const RunConditions& Get(int runnumber);
+
+    /* Start the spin DB query of this run in the background */
+    void Prefetch(int runnumber);
+
+    bool IsCached(int runnumber) const { return conditions.find(runnumber) != conditions.end(); }
+
+  protected:
+    ConditionsCache();
+
+    /* Store the result of a running prefetch */
+    void WaitPrefetch();
+
+    std::map<int, RunConditions> conditions;
+    std::vector<int> runlist;
+    bool dbaccess;
+
+    ConditionsPrefetch *prefetch;
+
+  private:
+    ConditionsCache(const ConditionsCache&);
+    ConditionsCache& operator=(const ConditionsCache&);
+};
+
+#endif /* __CONDITIONSCACHE_H__ */
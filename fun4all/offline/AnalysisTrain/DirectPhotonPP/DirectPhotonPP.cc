@@ -9,6 +9,8 @@
 #include "EmcLocalRecalibrator.h"
 #include "EmcLocalRecalibratorSasha.h"
 #include "EMCWarnmapChecker.h"
+#include "ConditionsCache.h"
+#include "StageProfiler.h"
 
 /* Other Fun4All header */
 #include <getClass.h>
@@ -20,8 +22,6 @@
 #include <emcClusterContainer.h>
 #include <PHGlobal.h>
 #include <TOAD.h>
-#include <SpinDBOutput.hh>
-#include <SpinDBContent.hh>
 
 /* ROOT header */
 #include <TH1.h>
@@ -38,6 +38,12 @@
 
 using namespace std;
 
+/* Stages for profiling */
+enum ProfileStage {kEvent, kRecalib, kSelect, kTriggerStats, kClusterPtSpectrum, kClusterTofSpectrum,
+  kPi0InvMass, kPhotonPtSpectrum, kIsolation, kTrackVeto, kClusters, nProfileStage};
+const char *const profile_stages[nProfileStage] = {"event", "recalib", "select", "trigger_stats", "cluster_pt_spectrum",
+  "cluster_tof_spectrum", "pi0_invmass", "photon_pt_spectrum", "isolation", "track_veto", "clusters"};
+
 DirectPhotonPP::DirectPhotonPP(const char* outfile) :
   _dsttype( "MinBias" ),
   _ievent( 0 ),
@@ -51,6 +57,7 @@ DirectPhotonPP::DirectPhotonPP(const char* outfile) :
   _emcrecalib( nullptr ),
   _emcrecalib_sasha( nullptr ),
   _emcwarnmap( nullptr ),
+  _prof( nullptr ),
   _debug_cluster( false ),
   _debug_trigger( false ),
   _debug_pi0( false )
@@ -110,6 +117,12 @@ DirectPhotonPP::Init(PHCompositeNode *topNode)
       for(int iz=0; iz<96; iz++)
         _tower_status[sec][iy][iz] = _emcwarnmap->GetStatusNils(sec, iy, iz);
 
+#ifdef DIRECTPHOTON_PROFILE
+  /* Initialize per-stage timing */
+  _prof = new StageProfiler( "DirectPhotonPP", vector<string>(profile_stages, profile_stages+nProfileStage) );
+  _prof->BookHistograms( _hm );
+#endif
+
   return EVENT_OK;
 }
 
@@ -127,20 +140,8 @@ DirectPhotonPP::InitRun(PHCompositeNode *topNode)
   }
   _runnumber = runheader->get_RunNumber();
 
-  /* Get fill number */
-  SpinDBContent spin_cont;
-  SpinDBOutput spin_out;
-
-  /*Initialize opbject to access spin DB*/
-  spin_out.Initialize();
-  spin_out.SetUserName("phnxrc");
-  spin_out.SetTableName("spin");
-
-  /* Retrieve entry from Spin DB and get fill number */
-  int qa_level=spin_out.GetDefaultQA(_runnumber);
-  spin_out.StoreDBContent(_runnumber, _runnumber, qa_level);
-  spin_out.GetDBContentStore(spin_cont, _runnumber);
-  int fillnumber = spin_cont.GetFillNumber();
+  /* Get fill number from the spin DB entry, cached or prefetched for all runs */
+  int fillnumber = ConditionsCache::instance()->Get(_runnumber).fillnumber;
 
   /* Load EMCal recalibrations for run and fill */
   if ( _emcrecalib )
@@ -157,6 +158,8 @@ DirectPhotonPP::InitRun(PHCompositeNode *topNode)
   int
 DirectPhotonPP::process_event(PHCompositeNode *topNode)
 {
+  PROFILE_STAGE( _prof, kEvent );
+
   /* count up event counter */
   _ievent++;
 
@@ -240,35 +243,51 @@ DirectPhotonPP::process_event(PHCompositeNode *topNode)
   /*
    * *** EVALUATE: Cluster information ***
    */
+  PROFILE_MULTIPLICITY( _prof, data_emc->size() );
+  PROFILE_COUNT( _prof, kClusters, data_emc->size() );
+
   /* Run local recalibration of EMCal cluster data */
   emcClusterContainer* data_emc_corr = data_emc->clone();
 
-  if ( _emcrecalib )
   {
-    _emcrecalib->ApplyClusterCorrection( data_emc_corr );
-  }
-  else if ( _emcrecalib_sasha )
-  {
-    _emcrecalib_sasha->ApplyClusterCorrection( _runnumber, data_emc_corr );
+    PROFILE_STAGE( _prof, kRecalib );
+
+    if ( _emcrecalib )
+    {
+      _emcrecalib->ApplyClusterCorrection( data_emc_corr );
+    }
+    else if ( _emcrecalib_sasha )
+    {
+      _emcrecalib_sasha->ApplyClusterCorrection( _runnumber, data_emc_corr );
+    }
   }
 
   /* Apply cuts to calorimeter cluster collections and create subsets for next analysis steps */
-  emcClusterContainer* data_emc_cwarn = data_emc->clone();
-  selectClusterGoodTower( data_emc_cwarn );
+  emcClusterContainer* data_emc_cwarn = nullptr;
+  emcClusterContainer* data_emc_cwarn_cshape_cenergy = nullptr;
+  emcClusterContainer* data_emc_corr_cwarn = nullptr;
+  emcClusterContainer* data_emc_corr_cwarn_cshape_cenergy = nullptr;
+  emcClusterContainer* data_emc_corr_cwarn_cshape_cenergy_ctof = nullptr;
+  {
+    PROFILE_STAGE( _prof, kSelect );
+
+    data_emc_cwarn = data_emc->clone();
+    selectClusterGoodTower( data_emc_cwarn );
 
-  emcClusterContainer* data_emc_cwarn_cshape_cenergy = data_emc_cwarn->clone();
-  selectClusterPhotonShape( data_emc_cwarn_cshape_cenergy );
-  selectClusterPhotonEnergy( data_emc_cwarn_cshape_cenergy );
+    data_emc_cwarn_cshape_cenergy = data_emc_cwarn->clone();
+    selectClusterPhotonShape( data_emc_cwarn_cshape_cenergy );
+    selectClusterPhotonEnergy( data_emc_cwarn_cshape_cenergy );
 
-  emcClusterContainer* data_emc_corr_cwarn = data_emc_corr->clone();
-  selectClusterGoodTower( data_emc_corr_cwarn );
+    data_emc_corr_cwarn = data_emc_corr->clone();
+    selectClusterGoodTower( data_emc_corr_cwarn );
 
-  emcClusterContainer* data_emc_corr_cwarn_cshape_cenergy = data_emc_corr_cwarn->clone();
-  selectClusterPhotonShape( data_emc_corr_cwarn_cshape_cenergy );
-  selectClusterPhotonEnergy( data_emc_corr_cwarn_cshape_cenergy );
+    data_emc_corr_cwarn_cshape_cenergy = data_emc_corr_cwarn->clone();
+    selectClusterPhotonShape( data_emc_corr_cwarn_cshape_cenergy );
+    selectClusterPhotonEnergy( data_emc_corr_cwarn_cshape_cenergy );
 
-  emcClusterContainer* data_emc_corr_cwarn_cshape_cenergy_ctof = data_emc_corr_cwarn_cshape_cenergy->clone();
-  selectClusterPhotonTof( data_emc_corr_cwarn_cshape_cenergy_ctof, bbc_t0 );
+    data_emc_corr_cwarn_cshape_cenergy_ctof = data_emc_corr_cwarn_cshape_cenergy->clone();
+    selectClusterPhotonTof( data_emc_corr_cwarn_cshape_cenergy_ctof, bbc_t0 );
+  }
 
   /* Print detailes cluster collection infomration for debugging purpose */
   if ( _debug_cluster )
@@ -429,6 +448,8 @@ DirectPhotonPP::FillTriggerStats( string histname,
     ErtOut *data_ert ,
     double bbc_z )
 {
+  PROFILE_STAGE( _prof, kTriggerStats );
+
 
   /* retrieve histograms used in this function */
   TH1* h1_events = static_cast<TH1*>( _hm->getHisto(histname) );
@@ -576,6 +597,8 @@ DirectPhotonPP::FillTriggerEfficiency( emcClusterContainer *data_emc,
 DirectPhotonPP::FillClusterPtSpectrum( string histname,
     emcClusterContainer *data_emc )
 {
+  PROFILE_STAGE( _prof, kClusterPtSpectrum );
+
 
   /* retrieve all histograms used in this function */
   TH2* h2_pT_1cluster        = static_cast<TH2*>( _hm->getHisto(histname) );
@@ -606,6 +629,8 @@ DirectPhotonPP::FillClusterTofSpectrum( string histname,
     PHGlobal *data_global,
     double bbc_t0 )
 {
+  PROFILE_STAGE( _prof, kClusterTofSpectrum );
+
 
   /* retrieve all histograms used in this function */
   THnSparse* hn_tof     = static_cast<THnSparse*>( _hm->getHisto(histname) );
@@ -639,6 +664,8 @@ DirectPhotonPP::FillPi0InvariantMass( string histname,
     TrigLvl1* data_triggerlvl1,
     ErtOut *data_ert )
 {
+  PROFILE_STAGE( _prof, kPi0InvMass );
+
   /* retrieve all histograms used in this function */
   THnSparse* hn_pion = static_cast<THnSparse*>( _hm->getHisto(histname) );
 
@@ -810,6 +837,8 @@ DirectPhotonPP::FillPhotonPtSpectrum( string histname_1photon,
     TrigLvl1* data_triggerlvl1,
     ErtOut *data_ert )
 {
+  PROFILE_STAGE( _prof, kPhotonPtSpectrum );
+
   THnSparse* hn_1photon          = static_cast<THnSparse*>( _hm->getHisto( histname_1photon ) );
   THnSparse* hn_2photon          = static_cast<THnSparse*>( _hm->getHisto( histname_2photon ) );
 
@@ -992,6 +1021,8 @@ DirectPhotonPP::FillPhotonPtSpectrum( string histname_1photon,
 DirectPhotonPP::End(PHCompositeNode *topNode)
 {
   /* Write histogram output to ROOT file */
+  if ( _prof )
+    _prof->Finish();
   _hm->dumpHistos();
   delete _hm;
 
@@ -1005,6 +1036,9 @@ DirectPhotonPP::End(PHCompositeNode *topNode)
   if ( _emcwarnmap )
     delete _emcwarnmap;
 
+  if ( _prof )
+    delete _prof;
+
   return EVENT_OK;
 }
 
@@ -1097,6 +1131,8 @@ DirectPhotonPP::testIsolatedCluster( emcClusterContent *emccluster0 ,
     double coneangle ,
     double threshold )
 {
+  PROFILE_STAGE( _prof, kIsolation );
+
   // check isolation
   double isocone_energy = 0;
 
@@ -1179,6 +1215,8 @@ DirectPhotonPP::testPhotonShape( emcClusterContent *emccluster )
   bool
 DirectPhotonPP::testPhotonTrackVeto( emcClusterContent *emccluster )
 {
+  PROFILE_STAGE( _prof, kTrackVeto );
+
   // Angle between EMC cluster and PC3 track
   double theta_cv = anatools::GetTheta_CV(emccluster);
 
@@ -11,6 +11,7 @@
 class EmcLocalRecalibrator;
 class EmcLocalRecalibratorSasha;
 class EMCWarnmapChecker;
+class StageProfiler;
 
 /* Fun4All classes */
 class PHCentralTrack;
@@ -324,6 +325,11 @@ protected:
    */
   EMCWarnmapChecker *_emcwarnmap;
 
+  /**
+   * Per-stage timing, only created with DIRECTPHOTON_PROFILE
+   */
+  StageProfiler *_prof;
+
   /**
    * Name for output ROOT file for histograms
    */
@@ -4,9 +4,12 @@
 #pragma link off all functions;
 
 #pragma link C++ class PhotonContainer+;
+#pragma link C++ class PhotonColumns+;
+#pragma link C++ class PhotonEventTag+;
 #pragma link C++ class Photon+;
 #pragma link C++ class PhotonERT+;
 #pragma link C++ class SpinPattern+;
+#pragma link C++ class ConditionsCache-!;
 #pragma link C++ class DirectPhotonPP-!;
 #pragma link C++ class PhotonNode-!;
 #pragma link C++ class PhotonHistos-!;
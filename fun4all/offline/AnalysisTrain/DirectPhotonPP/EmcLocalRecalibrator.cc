@@ -4,6 +4,9 @@
 #include <emcClusterContainer.h>
 #include <emcClusterContent.h>
 #include <TH1.h>
+#include <TDirectory.h>
+#include <TROOT.h>
+#include <TList.h>
 
 #include <iostream>
 #include <sstream>
@@ -14,7 +17,9 @@ using namespace std;
 
 EmcLocalRecalibrator::EmcLocalRecalibrator() : _file_warnmap(""),
   _file_tofmap(""),
-  _file_energycalibration("")
+  _file_energycalibration(""),
+  _tofmap_file(nullptr),
+  _tofmap_tree(nullptr)
 {
 
   for(int i=0;i<8;i++)
@@ -35,6 +40,11 @@ EmcLocalRecalibrator::EmcLocalRecalibrator() : _file_warnmap(""),
 
 }//EmcLocalRecalibrator::EmcLocalRecalibrator
 
+EmcLocalRecalibrator::~EmcLocalRecalibrator()
+{
+  CloseTofCorrection();
+}
+
 void EmcLocalRecalibrator::Setup()
 {
   TOAD *toad_loader = new TOAD("DirectPhotonPP");
@@ -111,13 +121,33 @@ void EmcLocalRecalibrator::ReadEnergyCorrection(const int& a_runnumber)
     exit(1);
   }
 
+  if( _energycalibration_table.empty() )
+    ReadEnergyCorrectionTable();
+
+  /* Keep the previous constants for runs not in the file */
+  map< int, vector<double> >::const_iterator it = _energycalibration_table.find(a_runnumber);
+  if( it == _energycalibration_table.end() )
+    return;
+
+  for(int i=0;i<8;++i)
+  {
+    int arm = i / 4;
+    int rawsector = i % 4;
+    int sector = anatools::CorrectClusterSector( arm, rawsector );
+
+    _energycalibration[sector] = it->second[i];
+  }
+
+  return;
+}//EmcLocalRecalibrator::ReadRunCalibMap
+
+
+void EmcLocalRecalibrator::ReadEnergyCorrectionTable()
+{
   ifstream calib_fin;
   calib_fin.open(_file_energycalibration.c_str());
 
-  Bool_t chk = kFALSE;
-  double con[8];
-
-  /* loop over lines in file */
+  /* loop over lines in file, the first line of a run is used */
   string calib_line;
   while ( getline( calib_fin, calib_line ) )
   {
@@ -126,28 +156,14 @@ void EmcLocalRecalibrator::ReadEnergyCorrection(const int& a_runnumber)
     istringstream iss(calib_line);
 
     int run;
+    vector<double> con(8);
 
-    //if ( !( iss >> dummys >> dummy >> idx_j >> idx_k >> idx_l >> pos_x >> pos_y >> pos_z >> size_x >> size_y >> size_z >> rot_x >> rot_y >> rot_z ) )
-    iss >> run >> con[0] >> con[1] >> con[2] >> con[3] >> con[4] >> con[5] >> con[6] >> con[7];
-
-    if(run==a_runnumber)
-    {
-      chk = kTRUE;
-      break;
-    }
-  }
-
-  for(int i=0;i<8;++i)
-  {
-    int arm = i / 4;
-    int rawsector = i % 4;
-    int sector = anatools::CorrectClusterSector( arm, rawsector );
-
-    if(chk==kTRUE) _energycalibration[sector] = con[i];
+    if( iss >> run >> con[0] >> con[1] >> con[2] >> con[3] >> con[4] >> con[5] >> con[6] >> con[7] )
+      _energycalibration_table.insert( make_pair(run, con) );
   }
 
   return;
-}//EmcLocalRecalibrator::ReadRunCalibMap
+}//EmcLocalRecalibrator::ReadEnergyCorrectionTable
 
 
 void EmcLocalRecalibrator::ReadTofCorrection( const int& a_fillnumber )
@@ -160,52 +176,30 @@ void EmcLocalRecalibrator::ReadTofCorrection( const int& a_fillnumber )
 
   cout << "Read from file " << _file_tofmap<< endl;
 
-  int fillnumber = a_fillnumber;
-
-  TFile* tofmapf = new TFile(_file_tofmap.c_str());
-  if(!tofmapf->IsOpen())
-  {
-    cout << PHWHERE << "Can not find tofmap file." << endl;
-    delete tofmapf;
-    exit(1);
-  }
+  if( !_tofmap_tree )
+    OpenTofCorrection();
 
-  TTree* Ttof = (TTree*)tofmapf->Get("T");
-  if(Ttof==nullptr)
-  {
-    cout << PHWHERE << "Can not find T in tofmap root file." << endl;
-    delete tofmapf;
-    exit(1);
-  }
-
-  int fill;
-  float tof[8][48][96];
-  Ttof->SetBranchAddress("fillnumber", &fill);
-  Ttof->SetBranchAddress("tof_correction", tof);
-
-  int nentries = Ttof->GetEntries();
-  Bool_t chk=kFALSE;
-  for(int i=0;i<nentries;++i)
-  {
-    Ttof->GetEntry(i);
-
-    if(fill==fillnumber)
-    {
-      cout << "Correct TOF corrrection entry is found." << endl;
-      chk = kTRUE;
-      break;
-    }
-  }
-  if(chk==kFALSE)
+  map<int, Long64_t>::const_iterator it = _tofmap_index.find(a_fillnumber);
+  if( it == _tofmap_index.end() )
   {
     cout << "Can not find correct TOF Correction entry." << endl;
     cout << "No TOF Correction." << endl;
 
-    delete tofmapf;
-
     return;
     //exit(1);
   }
+  cout << "Correct TOF corrrection entry is found." << endl;
+
+  float tof[8][48][96] = {};
+  _tofmap_tree->SetBranchStatus("tof_correction", 1);
+  _tofmap_tree->SetBranchAddress("tof_correction", tof);
+  int nbytes = _tofmap_tree->GetEntry(it->second);
+  _tofmap_tree->ResetBranchAddresses();
+  if( nbytes <= 0 )
+  {
+    cout << PHWHERE << "Can not read TOF Correction entry for fill " << a_fillnumber << endl;
+    exit(1);
+  }
 
   for(int i=0; i<8; i++)
   {
@@ -234,7 +228,60 @@ void EmcLocalRecalibrator::ReadTofCorrection( const int& a_fillnumber )
     }
   }
 
-  delete tofmapf;
-
   return;
 }//ReaMap::ReadTofMap
+
+
+void EmcLocalRecalibrator::OpenTofCorrection()
+{
+  /* The file stays open, do not make it the current directory for histograms booked later,
+   * and keep it out of the list of files, where the nDST reader looks for the DST tree "T" */
+  TDirectory *olddir = gDirectory;
+  _tofmap_file = new TFile(_file_tofmap.c_str());
+  gROOT->GetListOfFiles()->Remove(_tofmap_file);
+  olddir->cd();
+
+  if(!_tofmap_file->IsOpen())
+  {
+    cout << PHWHERE << "Can not find tofmap file." << endl;
+    CloseTofCorrection();
+    exit(1);
+  }
+
+  _tofmap_tree = (TTree*)_tofmap_file->Get("T");
+  if(_tofmap_tree==nullptr)
+  {
+    cout << PHWHERE << "Can not find T in tofmap root file." << endl;
+    CloseTofCorrection();
+    exit(1);
+  }
+
+  /* Only read the fill number to index the entries, the first entry of a fill is used */
+  int fill;
+  _tofmap_tree->SetBranchStatus("*", 0);
+  _tofmap_tree->SetBranchStatus("fillnumber", 1);
+  _tofmap_tree->SetBranchAddress("fillnumber", &fill);
+
+  Long64_t nentries = _tofmap_tree->GetEntries();
+  for(Long64_t i=0;i<nentries;++i)
+  {
+    _tofmap_tree->GetEntry(i);
+    _tofmap_index.insert( make_pair(fill, i) );
+  }
+
+  _tofmap_tree->SetBranchStatus("*", 1);
+  _tofmap_tree->ResetBranchAddresses();
+
+  return;
+}//EmcLocalRecalibrator::OpenTofCorrection
+
+
+void EmcLocalRecalibrator::CloseTofCorrection()
+{
+  delete _tofmap_file;
+  _tofmap_file = nullptr;
+  _tofmap_tree = nullptr;
+  _tofmap_index.clear();
+
+  return;
+}//EmcLocalRecalibrator::CloseTofCorrection
@@ -16,6 +16,8 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <map>
 #include <cstdlib>
 
 class emcClusterContainer;
@@ -38,7 +40,7 @@ class EmcLocalRecalibrator
     /**
      * Destructor
      */
-    ~EmcLocalRecalibrator() {}
+    ~EmcLocalRecalibrator();
 
     /**
      * Setup
@@ -51,12 +53,12 @@ class EmcLocalRecalibrator
     void ApplyClusterCorrection( emcClusterContainer* data_emccontainer );
 
     /**
-     * Read
+     * Read, the constants of all runs are read from the file on first use
      */
     void ReadEnergyCorrection(const int& a_runnumber);
 
     /**
-     * Read
+     * Read, the file is kept open with an index of the entry of each fill
      */
     void ReadTofCorrection( const int& a_fillnumber );
 
@@ -66,6 +68,7 @@ class EmcLocalRecalibrator
     void SetEnergyCorrectionFile( const std::string a_energycalibrationfile )
     {
       _file_energycalibration = a_energycalibrationfile;
+      _energycalibration_table.clear();
     }
 
     /**
@@ -74,6 +77,7 @@ class EmcLocalRecalibrator
     void SetTofCorrectionFile( const std::string a_tofmapfile )
     {
       _file_tofmap = a_tofmapfile;
+      CloseTofCorrection();
     }
 
   protected:
@@ -87,6 +91,17 @@ class EmcLocalRecalibrator
      */
     double GetCorrectedTof( const emcClusterContent *cluster );
 
+    /**
+     * Read run-by-run energy calibration of all runs
+     */
+    void ReadEnergyCorrectionTable();
+
+    /**
+     * Open TOF correction file and index its entries by fill number
+     */
+    void OpenTofCorrection();
+    void CloseTofCorrection();
+
     std::string _file_warnmap;
     std::string _file_tofmap;
     std::string _file_energycalibration;
@@ -94,8 +109,19 @@ class EmcLocalRecalibrator
     double _tofmap[25000];
     double _energycalibration[8];
 
+    std::map< int, std::vector<double> > _energycalibration_table;
+
+    TFile* _tofmap_file;
+    TTree* _tofmap_tree;
+    std::map<int, Long64_t> _tofmap_index;
+
     TF1* _pbsc_cor_func;
     TF1* _pbgl_cor_func;
+
+  private:
+    /* Owns the open TOF correction file */
+    EmcLocalRecalibrator(const EmcLocalRecalibrator&);
+    EmcLocalRecalibrator& operator=(const EmcLocalRecalibrator&);
 };
 
 #endif /* __EMCLOCALRECALIBRATOR_H__ */
@@ -0,0 +1,64 @@
+#include "HistogramFamily.h"
+
+#include <Fun4AllHistoManager.h>
+
+#include <TH1.h>
+
+#include <sstream>
+
+using namespace std;
+
+HistogramFamilyBase::~HistogramFamilyBase()
+{
+  /* Booked members are owned by the histogram manager */
+  delete proto;
+}
+
+void HistogramFamilyBase::Init(Fun4AllHistoManager *a_hm, const string &a_name, unsigned n, TH1 *a_proto)
+{
+  hm = a_hm;
+  name = a_name;
+  delete proto;
+  proto = a_proto;
+  proto->SetDirectory(0);
+  histos.assign(n, (TH1*)0);
+
+  return;
+}
+
+unsigned HistogramFamilyBase::GetNBooked() const
+{
+  unsigned nbooked = 0;
+  for(unsigned ih=0; ih<histos.size(); ih++)
+    if(histos[ih]) nbooked++;
+
+  return nbooked;
+}
+
+void HistogramFamilyBase::WriteEmpty() const
+{
+  for(unsigned ih=0; ih<histos.size(); ih++)
+    if(!histos[ih])
+    {
+      ostringstream hname;
+      hname << name << "_" << ih;
+      TH1 *h = (TH1*)proto->Clone(hname.str().c_str());
+      h->Write();
+      delete h;
+    }
+
+  return;
+}
+
+TH1* HistogramFamilyBase::Book(unsigned ih)
+{
+  ostringstream hname;
+  hname << name << "_" << ih;
+  TH1 *h = (TH1*)proto->Clone(hname.str().c_str());
+  /* Clone() adds to the current directory, e.g. the input file of the event */
+  h->SetDirectory(0);
+  hm->registerHisto(h);
+  histos[ih] = h;
+
+  return h;
+}
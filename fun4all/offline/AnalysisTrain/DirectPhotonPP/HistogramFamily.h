@@ -0,0 +1,58 @@
+#ifndef __HISTOGRAMFAMILY_H__
+#define __HISTOGRAMFAMILY_H__
+
+#include <string>
+#include <vector>
+
+class Fun4AllHistoManager;
+class TH1;
+
+/* Array of histograms with the same binning, booked on first access.
+ * Member ih is a clone of the prototype named <name>_<ih>, created and
+ * registered to the histogram manager the first time it is requested, so
+ * members never filled in a job cost no memory. WriteEmpty() writes empty
+ * placeholders for the members never booked, e.g. after dumpHistos(). */
+class HistogramFamilyBase
+{
+  public:
+    HistogramFamilyBase(): hm(0), proto(0) {}
+    virtual ~HistogramFamilyBase();
+
+    /* Takes ownership of the prototype */
+    void Init(Fun4AllHistoManager *a_hm, const std::string &a_name, unsigned n, TH1 *a_proto);
+
+    unsigned size() const { return histos.size(); }
+    bool IsBooked(unsigned ih) const { return histos[ih] != 0; }
+    unsigned GetNBooked() const;
+
+    /* Write empty members never booked to the current directory */
+    void WriteEmpty() const;
+
+  protected:
+    TH1* Book(unsigned ih);
+
+    Fun4AllHistoManager *hm;
+    std::string name;
+    TH1 *proto;
+    std::vector<TH1*> histos;
+
+  private:
+    HistogramFamilyBase(const HistogramFamilyBase&);
+    HistogramFamilyBase& operator=(const HistogramFamilyBase&);
+};
+
+template<class T>
+class HistogramFamily: public HistogramFamilyBase
+{
+  public:
+    T* operator[](unsigned ih)
+    {
+      TH1 *h = histos[ih];
+      if(!h) h = Book(ih);
+      return static_cast<T*>(h);
+    }
+
+    const T* GetPrototype() const { return static_cast<const T*>(proto); }
+};
+
+#endif /* __HISTOGRAMFAMILY_H__ */
@@ -24,6 +24,7 @@ class Photon: public PHObject
     bool get_trg2() const { return ( trig & 0x0002 ); }
     bool get_trg3() const { return ( trig & 0x0004 ); }
     bool get_prob() const { return ( trig & 0x0008 ); }
+    unsigned short get_trig_word() const { return trig; }
 
     void set_towerid(short a_towerid) { towerid = a_towerid; }
     void set_x(float a_x) { x = a_x; }
@@ -34,6 +35,7 @@ class Photon: public PHObject
     void set_tof(float a_tof) { tof = a_tof; }
     void set_trig(ErtOut *ertout, emcClusterContent *cluster);
     void set_prob(bool is_prob = true);
+    void set_trig_word(unsigned short a_trig) { trig = a_trig; }
 
   protected:
     short towerid;
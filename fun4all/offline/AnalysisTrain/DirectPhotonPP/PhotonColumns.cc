@@ -0,0 +1,152 @@
+#include "PhotonColumns.h"
+#include "PhotonContainer.h"
+#include "Photon.h"
+
+#include <TClass.h>
+
+#include <cmath>
+#include <limits>
+
+ClassImp(PhotonColumns)
+
+/* Packing resolution for positions [cm] and ToF [ns] */
+const float PhotonColumns::pos_scale = 0.02;
+const float PhotonColumns::tof_scale = 0.01;
+
+/* Packed value of NaN, the valid range is symmetric around it */
+const short packed_nan = -32768;
+
+void PhotonColumns::Reset()
+{
+  Class()->IgnoreTObjectStreamer();
+
+  bbc_z = -9999.;
+  bbc_t0 = -9999.;
+  trig = 0;
+
+  towerid.clear();
+  x.clear();
+  y.clear();
+  z.clear();
+  E.clear();
+  Ecorr.clear();
+  tof.clear();
+  photon_trig.clear();
+
+  x_packed.clear();
+  y_packed.clear();
+  z_packed.clear();
+  tof_packed.clear();
+}
+
+void PhotonColumns::Fill(const PhotonContainer *photoncont)
+{
+  Reset();
+
+  bbc_z = photoncont->get_bbc_z();
+  bbc_t0 = photoncont->get_bbc_t0();
+  trig = photoncont->get_trig_word();
+
+  unsigned nphotons = photoncont->Size();
+
+  towerid.reserve(nphotons);
+  E.reserve(nphotons);
+  Ecorr.reserve(nphotons);
+  photon_trig.reserve(nphotons);
+  if(packed)
+  {
+    x_packed.reserve(nphotons);
+    y_packed.reserve(nphotons);
+    z_packed.reserve(nphotons);
+    tof_packed.reserve(nphotons);
+  }
+  else
+  {
+    x.reserve(nphotons);
+    y.reserve(nphotons);
+    z.reserve(nphotons);
+    tof.reserve(nphotons);
+  }
+
+  for(unsigned i=0; i<nphotons; i++)
+  {
+    const Photon *photon = photoncont->GetPhoton(i);
+
+    towerid.push_back( photon->get_towerid() );
+    E.push_back( photon->get_E() );
+    Ecorr.push_back( photon->get_Ecorr() );
+    photon_trig.push_back( photon->get_trig_word() );
+
+    if(packed)
+    {
+      x_packed.push_back( Pack(photon->get_x(), pos_scale) );
+      y_packed.push_back( Pack(photon->get_y(), pos_scale) );
+      z_packed.push_back( Pack(photon->get_z(), pos_scale) );
+      tof_packed.push_back( Pack(photon->get_tof(), tof_scale) );
+    }
+    else
+    {
+      x.push_back( photon->get_x() );
+      y.push_back( photon->get_y() );
+      z.push_back( photon->get_z() );
+      tof.push_back( photon->get_tof() );
+    }
+  }
+
+  return;
+}
+
+void PhotonColumns::Export(PhotonContainer *photoncont) const
+{
+  photoncont->Reset();
+
+  photoncont->set_bbc_z(bbc_z);
+  photoncont->set_bbc_t0(bbc_t0);
+  photoncont->set_trig_word(trig);
+
+  unsigned nphotons = Size();
+  Photon photon;
+  for(unsigned i=0; i<nphotons; i++)
+  {
+    GetPhoton(i, photon);
+    photoncont->AddPhoton(photon);
+  }
+
+  return;
+}
+
+void PhotonColumns::GetPhoton(unsigned i, Photon &photon) const
+{
+  photon.set_towerid( get_towerid(i) );
+  photon.set_x( get_x(i) );
+  photon.set_y( get_y(i) );
+  photon.set_z( get_z(i) );
+  photon.set_E( get_E(i) );
+  photon.set_Ecorr( get_Ecorr(i) );
+  photon.set_tof( get_tof(i) );
+  photon.set_trig_word( get_trig_word(i) );
+
+  return;
+}
+
+short PhotonColumns::Pack(float value, float scale)
+{
+  if( std::isnan(value) )
+    return packed_nan;
+
+  /* Round to the nearest step and saturate at the short range,
+   * infinities saturate as well */
+  float step = std::floor( value / scale + 0.5 );
+  if( !(step < 32767.) ) step = 32767.;
+  else if( !(step > -32767.) ) step = -32767.;
+
+  return (short)step;
+}
+
+float PhotonColumns::UnpackValue(short value, float scale)
+{
+  if( value == packed_nan )
+    return std::numeric_limits<float>::quiet_NaN();
+
+  return value * scale;
+}
@@ -0,0 +1,82 @@
+#ifndef __PHOTONCOLUMNS_H__
+#define __PHOTONCOLUMNS_H__
+
+#include <PHObject.h>
+
+#include <vector>
+
+class PhotonContainer;
+class Photon;
+
+/* Column-oriented photon node for nDST.
+ * Each photon field is stored in its own contiguous vector, so with a split
+ * output tree every column goes to its own branch and no Photon object is
+ * streamed. Positions and ToF can optionally be packed into shorts
+ * (0.02 cm and 0.01 ns resolution) to further shrink the output, NaN is
+ * stored as -32768 and read back as NaN. */
+class PhotonColumns: public PHObject
+{
+  public:
+    PhotonColumns(): packed(false) { Reset(); }
+    virtual ~PhotonColumns() {}
+
+    void Reset();
+
+    /* Copy photons and event information from/to the object based container.
+     * Export() copies every photon, it is meant for consumers modifying the
+     * photons (e.g. recalibration), read-only consumers use the accessors
+     * below or GetPhoton(). */
+    void Fill(const PhotonContainer *photoncont);
+    void Export(PhotonContainer *photoncont) const;
+
+    /* Set photon to photon i, no allocation */
+    void GetPhoton(unsigned i, Photon &photon) const;
+
+    unsigned Size() const { return towerid.size(); }
+    bool IsPacked() const { return packed; }
+    void SetPacked(bool a_packed = true) { packed = a_packed; }
+
+    float get_bbc_z() const { return bbc_z; }
+    float get_bbc_t0() const { return bbc_t0; }
+    unsigned short get_trig_word() const { return trig; }
+
+    short get_towerid(unsigned i) const { return towerid[i]; }
+    float get_x(unsigned i) const { return packed ? UnpackValue(x_packed[i], pos_scale) : x[i]; }
+    float get_y(unsigned i) const { return packed ? UnpackValue(y_packed[i], pos_scale) : y[i]; }
+    float get_z(unsigned i) const { return packed ? UnpackValue(z_packed[i], pos_scale) : z[i]; }
+    float get_E(unsigned i) const { return E[i]; }
+    float get_Ecorr(unsigned i) const { return Ecorr[i]; }
+    float get_tof(unsigned i) const { return packed ? UnpackValue(tof_packed[i], tof_scale) : tof[i]; }
+    unsigned short get_trig_word(unsigned i) const { return photon_trig[i]; }
+
+  protected:
+    static short Pack(float value, float scale);
+    static float UnpackValue(short value, float scale);
+
+    static const float pos_scale;
+    static const float tof_scale;
+
+    bool packed;
+
+    float bbc_z;
+    float bbc_t0;
+    unsigned short trig;
+
+    std::vector<short> towerid;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> E;
+    std::vector<float> Ecorr;
+    std::vector<float> tof;
+    std::vector<unsigned short> photon_trig;
+
+    std::vector<short> x_packed;
+    std::vector<short> y_packed;
+    std::vector<short> z_packed;
+    std::vector<short> tof_packed;
+
+    ClassDef(PhotonColumns, 1)
+};
+
+#endif /* __PHOTONCOLUMNS_H__ */
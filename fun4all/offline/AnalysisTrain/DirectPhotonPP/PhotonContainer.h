@@ -32,11 +32,13 @@ class PhotonContainer: public PHObject
     bool get_bbcnovtx_scaled() const { return ( trig & 0x1000 ); }
     bool get_bbcwide_scaled() const { return ( trig & 0x2000 ); }
     bool get_bbcnarrow_scaled() const { return ( trig & 0x4000 ); }
+    unsigned short get_trig_word() const { return trig; }
 
     void set_bbc_z(float a_bbc_z) { bbc_z = a_bbc_z; }
     void set_bbc_t0(float a_bbc_t0) { bbc_t0 = a_bbc_t0; }
     //void set_crossing(short a_crossing) { crossing = a_crossing; }
     void set_trigger(unsigned lvl1_live, unsigned lvl1_scaled);
+    void set_trig_word(unsigned short a_trig) { trig = a_trig; }
     
   protected:
     std::vector<Photon> photon_list;
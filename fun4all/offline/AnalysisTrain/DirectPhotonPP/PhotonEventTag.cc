@@ -0,0 +1,36 @@
+#include "PhotonEventTag.h"
+#include "PhotonContainer.h"
+#include "Photon.h"
+
+#include <TClass.h>
+
+ClassImp(PhotonEventTag)
+
+void PhotonEventTag::Reset()
+{
+  Class()->IgnoreTObjectStreamer();
+
+  trig = 0;
+  nphotons = 0;
+  bbc_z = -9999.;
+  emax = 0.;
+}
+
+void PhotonEventTag::Fill(const PhotonContainer *photoncont)
+{
+  trig = photoncont->get_trig_word();
+  bbc_z = photoncont->get_bbc_z();
+
+  unsigned size = photoncont->Size();
+  nphotons = size < 0xFFFF ? size : 0xFFFF;
+
+  emax = 0.;
+  for(unsigned i=0; i<size; i++)
+  {
+    float ecorr = photoncont->GetPhoton(i)->get_Ecorr();
+    if( ecorr > emax )
+      emax = ecorr;
+  }
+
+  return;
+}
@@ -0,0 +1,47 @@
+#ifndef __PHOTONEVENTTAG_H__
+#define __PHOTONEVENTTAG_H__
+
+#include <PHObject.h>
+
+class PhotonContainer;
+
+/* Small per-event summary written next to the photon payload.
+ * Readers can decide from trigger bits, vertex, photon count and
+ * maximum photon energy whether an event is needed at all
+ * before touching the PhotonContainer or PhotonColumns node. */
+class PhotonEventTag: public PHObject
+{
+  public:
+    PhotonEventTag() { Reset(); }
+    virtual ~PhotonEventTag() {}
+
+    void Reset();
+    void Fill(const PhotonContainer *photoncont);
+
+    float get_bbc_z() const { return bbc_z; }
+    unsigned short get_nphotons() const { return nphotons; }
+    float get_emax() const { return emax; }
+    unsigned short get_trig_word() const { return trig; }
+    bool get_ert_a_live() const { return ( trig & 0x0001 ); }
+    bool get_ert_b_live() const { return ( trig & 0x0002 ); }
+    bool get_ert_c_live() const { return ( trig & 0x0004 ); }
+    bool get_ert_a_scaled() const { return ( trig & 0x0010 ); }
+    bool get_ert_b_scaled() const { return ( trig & 0x0020 ); }
+    bool get_ert_c_scaled() const { return ( trig & 0x0040 ); }
+    bool get_bbcnovtx_live() const { return ( trig & 0x0100 ); }
+    bool get_bbcwide_live() const { return ( trig & 0x0200 ); }
+    bool get_bbcnarrow_live() const { return ( trig & 0x0400 ); }
+    bool get_bbcnovtx_scaled() const { return ( trig & 0x1000 ); }
+    bool get_bbcwide_scaled() const { return ( trig & 0x2000 ); }
+    bool get_bbcnarrow_scaled() const { return ( trig & 0x4000 ); }
+
+  protected:
+    unsigned short trig;
+    unsigned short nphotons;
+    float bbc_z;
+    float emax;
+
+    ClassDef(PhotonEventTag, 1)
+};
+
+#endif /* __PHOTONEVENTTAG_H__ */
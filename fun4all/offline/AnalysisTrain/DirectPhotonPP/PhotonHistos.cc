@@ -9,10 +9,10 @@
 #include "EMCWarnmapChecker.h"
 #include "DCDeadmapChecker.h"
 #include "SpinPattern.h"
+#include "ConditionsCache.h"
+#include "StageProfiler.h"
 
 #include <RunHeader.h>
-#include <SpinDBOutput.hh>
-#include <SpinDBContent.hh>
 
 #include <PHGlobal.h>
 #include <EmcIndexer.h>
@@ -35,6 +35,7 @@
 #include <TH1.h>
 #include <TH2.h>
 #include <TH3.h>
+#include <TFile.h>
 
 #include <iostream>
 #include <fstream>
@@ -69,6 +70,14 @@ const unsigned bit_bbcnarrow = 0x00000010;
 const unsigned bit_bbcnovtx = 0x00000002;
 const unsigned bit_ert4x4[4] = {0x00000080, 0x00000040, 0x00000100, 0x000001C0};  // ert4x4a/b/c/or
 
+/* Stages for profiling */
+enum ProfileStage {kEvent, kClone, kRecalib, kEventCounts, kTofSpectrum, kPi0InvMass,
+  kBBCEfficiency, kERTEfficiency, kTrackQuality, kPi0Spectrum, kPhotonSpectrum, kCutVariants,
+  kSumEEmcal, kSumPTrack, kSumEPi0, kChargeVeto, kClusters, nProfileStage};
+const char *const profile_stages[nProfileStage] = {"event", "clone", "recalib", "event_counts", "tof_spectrum", "pi0_invmass",
+  "bbc_efficiency", "ert_efficiency", "track_quality", "pi0_spectrum", "photon_spectrum", "cut_variants",
+  "sum_e_emcal", "sum_p_track", "sum_e_pi0", "charge_veto", "clusters"};
+
 /* pT bins for ALL */
 double PhotonHistos::pTbin_pol[] = { 2.0,
   2.5, 3.0, 3.5, 4.0, 4.5, 5.0, 6.0, 7.0, 8.0, 9.0,
@@ -81,9 +90,11 @@ PhotonHistos::PhotonHistos(const string &name, const char *filename) :
   emcwarnmap(nullptr),
   dcdeadmap(nullptr),
   spinpattern(nullptr),
+  prof(nullptr),
   runnumber(0),
   fillnumber(0),
-  hm(nullptr)
+  hm(nullptr),
+  writeEmpty(false)
 {
   datatype = ERT;
 
@@ -92,59 +103,9 @@ PhotonHistos::PhotonHistos(const string &name, const char *filename) :
 
   h_events = nullptr;
   h_prod = nullptr;
-  for(int ih=0; ih<nh_calib; ih++)
-  {
-    h2_tof[ih] = nullptr;
-    h2_minv[ih] = nullptr;
-  }
-  for(int ih=0; ih<nh_bbc; ih++)
-  {
-    h_bbc[ih] = nullptr;
-    h2_bbc_pion[ih] = nullptr;
-  }
-  for(int ih=0; ih<nh_ertsm; ih++)
-    h2_ertsm[ih] = nullptr;
-  for(int ih=0; ih<nh_ert; ih++)
-  {
-    h_ert[ih] = nullptr;
-    h2_ert_pion[ih] = nullptr;
-  }
-  for(int ih=0; ih<nh_dcpartqual; ih++)
-  {
-    h3_dcdphiz[ih] = nullptr;
-    h2_alphaboard[ih] = nullptr;
-  }
-  for(int ih=0; ih<nh_dcgood; ih++)
-    h3_dclive[ih] = nullptr;
-  for(int ih=0; ih<nh_pion; ih++)
-    h2_pion[ih] = nullptr;
-  for(int ih=0; ih<nh_pion_pol; ih++)
-    h2_pion_pol[ih] = nullptr;
+  h2_photon_bunch = nullptr;
   for(int ih=0; ih<nh_eta_phi; ih++)
     h2_eta_phi[ih] = nullptr;
-  for(int ih=0; ih<nh_1photon; ih++)
-    h_1photon[ih] = nullptr;
-  for(int ih=0; ih<nh_1photon_pol; ih++)
-    h_1photon_pol[ih] = nullptr;
-  for(int ih=0; ih<nh_photon_bunch; ih++)
-    h_photon_bunch[ih] = nullptr;
-  for(int ih=0; ih<nh_2photon; ih++)
-  {
-    h2_2photon[ih] = nullptr;
-    h2_2photon2pt[ih] = nullptr;
-  }
-  for(int ih=0; ih<nh_2photon_pol; ih++)
-  {
-    h2_2photon_pol[ih] = nullptr;
-    h2_2photon2pt_pol[ih] = nullptr;
-  }
-  for(int ih=0; ih<nh_mul_pion; ih++)
-  {
-    h2_mul_pion_sig[ih] = nullptr;
-    h2_mul_pion_bg[ih] = nullptr;
-  }
-  for(int ih=0; ih<nh_mul_photon; ih++)
-    h2_mul_photon[ih] = nullptr;
 }
 
 PhotonHistos::~PhotonHistos()
@@ -195,6 +156,11 @@ int PhotonHistos::Init(PHCompositeNode *topNode)
   /* Book histograms and graphs */
   BookHistograms();
 
+#ifdef DIRECTPHOTON_PROFILE
+  prof = new StageProfiler( "PhotonHistos", vector<string>(profile_stages, profile_stages+nProfileStage) );
+  prof->BookHistograms(hm);
+#endif
+
   return EVENT_OK;
 }
 
@@ -209,19 +175,9 @@ int PhotonHistos::InitRun(PHCompositeNode *topNode)
   }
   runnumber = runheader->get_RunNumber();
 
-  SpinDBOutput spin_out;
-  SpinDBContent spin_cont;
-
-  /* Initialize object to access spin DB */
-  spin_out.Initialize();
-  spin_out.SetUserName("phnxrc");
-  spin_out.SetTableName("spin");
-
-  /* Retrieve entry from Spin DB and get fill number */
-  int qa_level = spin_out.GetDefaultQA(runnumber);
-  spin_out.StoreDBContent(runnumber, runnumber, qa_level);
-  spin_out.GetDBContentStore(spin_cont, runnumber);
-  fillnumber = spin_cont.GetFillNumber();
+  /* Spin DB entry and fill number, cached or prefetched for all runs */
+  const RunConditions &cond = ConditionsCache::instance()->Get(runnumber);
+  fillnumber = cond.fillnumber;
 
   /* Load EMCal recalibrations for run and fill */
   emcrecalib->ReadEnergyCorrection(runnumber);
@@ -231,9 +187,8 @@ int PhotonHistos::InitRun(PHCompositeNode *topNode)
   dcdeadmap->SetMapByRunnumber(runnumber);
 
   /* Update spinpattern */
-  if( spin_out.CheckRunRow(runnumber,qa_level) == 1 &&
-      spin_cont.GetRunNumber() == runnumber )
-    UpdateSpinPattern(spin_cont);
+  if( cond.spin_ok )
+    UpdateSpinPattern(cond.spinpattern);
   else
     spinpattern->Reset();
 
@@ -242,6 +197,8 @@ int PhotonHistos::InitRun(PHCompositeNode *topNode)
 
 int PhotonHistos::process_event(PHCompositeNode *topNode)
 {
+  PROFILE_STAGE(prof, kEvent);
+
   PHGlobal *data_global = findNode::getClass<PHGlobal>(topNode, "PHGlobal");
   TrigLvl1 *data_triggerlvl1 = findNode::getClass<TrigLvl1>(topNode, "TrigLvl1");
   ErtOut *data_ert = findNode::getClass<ErtOut>(topNode, "ErtOut");
@@ -285,12 +242,21 @@ int PhotonHistos::process_event(PHCompositeNode *topNode)
   unsigned lvl1_scaled = data_triggerlvl1->get_lvl1_trigscaled();
   if( (lvl1_live & bit_ppg) || (lvl1_scaled & bit_ppg) ) return DISCARDEVENT;
 
+  PROFILE_MULTIPLICITY(prof, data_emccontainer_raw->size());
+  PROFILE_COUNT(prof, kClusters, data_emccontainer_raw->size());
+
   /* Run local recalibration of EMCal cluster data */
   emcClusterContainer *data_emccontainer[2];
-  for(int i=0; i<2; i++)
-    data_emccontainer[i] = data_emccontainer_raw->clone();
-  emcrecalib_sasha->ApplyClusterCorrection( runnumber, data_emccontainer[0] );
-  emcrecalib->ApplyClusterCorrection( data_emccontainer[1] );
+  {
+    PROFILE_STAGE(prof, kClone);
+    for(int i=0; i<2; i++)
+      data_emccontainer[i] = data_emccontainer_raw->clone();
+  }
+  {
+    PROFILE_STAGE(prof, kRecalib);
+    emcrecalib_sasha->ApplyClusterCorrection( runnumber, data_emccontainer[0] );
+    emcrecalib->ApplyClusterCorrection( data_emccontainer[1] );
+  }
 
   /* Event counts */
   FillEventCounts(data_global, data_triggerlvl1);
@@ -320,6 +286,10 @@ int PhotonHistos::process_event(PHCompositeNode *topNode)
   for(int i=0; i<2; i++)
     FillPhotonSpectrum(i, data_emccontainer[i], data_tracks, data_global, data_triggerlvl1, data_ert);
 
+  /* Analyze direct photon for cut variants */
+  if( !cutvariants.empty() )
+    FillCutVariants(data_emccontainer[0], data_tracks, data_global, data_triggerlvl1, data_ert);
+
   /* Clean up */
   for(int i=0; i<2; i++)
     delete data_emccontainer[i];
@@ -329,6 +299,8 @@ int PhotonHistos::process_event(PHCompositeNode *topNode)
 
 int PhotonHistos::FillEventCounts(const PHGlobal *data_global, const TrigLvl1 *data_triggerlvl1)
 {
+  PROFILE_STAGE(prof, kEventCounts);
+
   /* Get trigger */
   const unsigned lvl1_live = data_triggerlvl1->get_lvl1_triglive();
   const unsigned lvl1_scaled = data_triggerlvl1->get_lvl1_trigscaled();
@@ -379,6 +351,8 @@ int PhotonHistos::FillEventCounts(const PHGlobal *data_global, const TrigLvl1 *d
 
 int PhotonHistos::FillClusterTofSpectrum(const emcClusterContainer *data_emccontainer, const PHGlobal *data_global, const string &quali)
 {
+  PROFILE_STAGE(prof, kTofSpectrum);
+
   /* Get event global parameters */
   double bbc_z = data_global->getBbcZVertex();
   if( fabs(bbc_z) > 30. ) return DISCARDEVENT;
@@ -414,6 +388,8 @@ int PhotonHistos::FillClusterTofSpectrum(const emcClusterContainer *data_emccont
 
 int PhotonHistos::FillPi0InvariantMass(const emcClusterContainer *data_emccontainer, const PHGlobal *data_global, const string &quali)
 {
+  PROFILE_STAGE(prof, kPi0InvMass);
+
   /* Get event global parameters */
   double bbc_z = data_global->getBbcZVertex();
   if( fabs(bbc_z) > 30. ) return DISCARDEVENT;
@@ -461,6 +437,8 @@ int PhotonHistos::FillPi0InvariantMass(const emcClusterContainer *data_emccontai
 
 int PhotonHistos::FillBBCEfficiency(const emcClusterContainer *data_emccontainer, const TrigLvl1 *data_triggerlvl1)
 {
+  PROFILE_STAGE(prof, kBBCEfficiency);
+
   /* Check trigger */
   const unsigned lvl1_live = data_triggerlvl1->get_lvl1_triglive();
   const unsigned lvl1_scaled = data_triggerlvl1->get_lvl1_trigscaled();
@@ -521,6 +499,8 @@ int PhotonHistos::FillBBCEfficiency(const emcClusterContainer *data_emccontainer
 int PhotonHistos::FillERTEfficiency(const emcClusterContainer *data_emccontainer, const PHCentralTrack *data_tracks,
     const PHGlobal *data_global, const TrigLvl1 *data_triggerlvl1, const ErtOut *data_ert)
 {
+  PROFILE_STAGE(prof, kERTEfficiency);
+
   /* Get event global parameters */
   if( !BBC10cm(data_global, data_triggerlvl1) )
     return DISCARDEVENT;
@@ -651,6 +631,8 @@ int PhotonHistos::FillERTEfficiency(const emcClusterContainer *data_emccontainer
 int PhotonHistos::FillTrackQuality(const emcClusterContainer *data_emccontainer, const PHCentralTrack *data_tracks,
     const PHGlobal *data_global, const TrigLvl1 *data_triggerlvl1, const ErtOut *data_ert)
 {
+  PROFILE_STAGE(prof, kTrackQuality);
+
   /* Require ERT_4x4c and BBC 30cm vertex cut */
   double bbc_z = data_global->getBbcZVertex();
   if( !IsEventType(2, data_triggerlvl1) ||
@@ -716,6 +698,8 @@ int PhotonHistos::FillTrackQuality(const emcClusterContainer *data_emccontainer,
 int PhotonHistos::FillPi0Spectrum(const int ical, const emcClusterContainer *data_emccontainer, const PHCentralTrack *data_tracks,
     const PHGlobal *data_global, const TrigLvl1 *data_triggerlvl1, const ErtOut *data_ert)
 {
+  PROFILE_STAGE(prof, kPi0Spectrum);
+
   /* Get event global parameters */
   double bbc_z = data_global->getBbcZVertex();
   if( fabs(bbc_z) > 30. ) return DISCARDEVENT;
@@ -857,6 +841,8 @@ int PhotonHistos::FillPi0Spectrum(const int ical, const emcClusterContainer *dat
 int PhotonHistos::FillPhotonSpectrum(const int ical, const emcClusterContainer *data_emccontainer, const PHCentralTrack *data_tracks,
     const PHGlobal *data_global, const TrigLvl1 *data_triggerlvl1, const ErtOut *data_ert)
 {
+  PROFILE_STAGE(prof, kPhotonSpectrum);
+
   /* Get event global parameters */
   double bbc_z = data_global->getBbcZVertex();
   if( fabs(bbc_z) > 30. ) return DISCARDEVENT;
@@ -962,7 +948,7 @@ int PhotonHistos::FillPhotonSpectrum(const int ical, const emcClusterContainer *
               if(beam == 2)
               {
                 int ih = isolated[1] + 6*evenodd + 6*2*(bunch/2) + 6*2*60*checkmap + 6*2*60*2*ical;
-                h_photon_bunch[ih]->Fill(pT);
+                h2_photon_bunch->Fill(pT, ih);
               }
 
               if( pT > pTbin_pol[0] )
@@ -1029,7 +1015,7 @@ int PhotonHistos::FillPhotonSpectrum(const int ical, const emcClusterContainer *
                     if( minv > 0.112 && minv < 0.162 )
                     {
                       if(beam == 2)
-                        h_photon_bunch[2+2*pttype+ih]->Fill(fill_pT);
+                        h2_photon_bunch->Fill(fill_pT, 2+2*pttype+ih);
                       if( pTcmp[pttype] > pTbin_pol[0] )
                         mul_photon[2+2*pttype][beam][checkmap][ipt[pttype]]++;
                     }
@@ -1037,7 +1023,7 @@ int PhotonHistos::FillPhotonSpectrum(const int ical, const emcClusterContainer *
                         (minv > 0.177 && minv < 0.227) )
                     {
                       if(beam == 2)
-                        h_photon_bunch[3+2*pttype+ih]->Fill(fill_pT);
+                        h2_photon_bunch->Fill(fill_pT, 3+2*pttype+ih);
                       if( pTcmp[pttype] > pTbin_pol[0] )
                         mul_photon[3+2*pttype][beam][checkmap][ipt[pttype]]++;
                     }
@@ -1065,15 +1051,212 @@ int PhotonHistos::FillPhotonSpectrum(const int ical, const emcClusterContainer *
   return EVENT_OK;
 }
 
+int PhotonHistos::FillCutVariants(const emcClusterContainer *data_emccontainer, const PHCentralTrack *data_tracks,
+    const PHGlobal *data_global, const TrigLvl1 *data_triggerlvl1, const ErtOut *data_ert)
+{
+  PROFILE_STAGE(prof, kCutVariants);
+
+  /* Get event global parameters */
+  if( !BBC10cm(data_global, data_triggerlvl1) ) return DISCARDEVENT;
+  double bbc_t0 = data_global->getBbcTimeZero();
+
+  bool evtrig[3] = {};
+  for(int evtype=0; evtype<3; evtype++)
+    evtrig[evtype] = IsEventType(evtype, data_triggerlvl1);
+  if( !evtrig[0] && !evtrig[1] && !evtrig[2] ) return DISCARDEVENT;
+
+  /* Same selection as nominal histograms with DC deadmap
+   * and charge veto for both EMCal and tracks (ival = 1) */
+  dcdeadmap->Checkmap(true);
+
+  /* Cluster quantities and photon cuts for all variants */
+  const unsigned nvariant = cutvariants.size();
+  const unsigned ncluster = data_emccontainer->size();
+  cluster_cache.resize(ncluster);
+
+  for(unsigned i=0; i<ncluster; i++)
+  {
+    emcClusterContent *cluster = data_emccontainer->getCluster(i);
+    ClusterCache &cc = cluster_cache[i];
+
+    TLorentzVector pE = anatools::Get_pE(cluster);
+    cc.valid = pE.Pt() >= epsilon;
+    if(cc.valid)
+    {
+      TVector2 v2 = pE.EtaPhiVector();
+      cc.eta = v2.X();
+      cc.phi = v2.Y();
+    }
+    cc.pT = anatools::Get_pT(cluster);
+    cc.ecore = cluster->ecore();
+    cc.tof = cluster->tofcorr() - bbc_t0;
+    cc.prob = cluster->prob_photon();
+    cc.part = anatools::GetPart(cluster);
+    cc.good_tower = emcwarnmap->IsGoodTower(cluster);
+    cc.bad_tower = emcwarnmap->IsBadTower(cluster);
+    cc.charge_veto = dcdeadmap->ChargeVeto(cluster, data_tracks);
+
+    cc.photon = 0;
+    if( cc.ecore > eMin && fabs(cc.tof) < tofMax )
+      for(unsigned ivar=0; ivar<nvariant; ivar++)
+        if( cc.prob > cutvariants[ivar].prob_min )
+          cc.photon |= 1U << ivar;
+  }
+
+  /* Track quantities */
+  const unsigned npart = data_tracks->get_npart();
+  track_cache.resize(npart);
+
+  for(unsigned itrk=0; itrk<npart; itrk++)
+  {
+    TrackCache &tc = track_cache[itrk];
+    double px = data_tracks->get_px(itrk);
+    double py = data_tracks->get_py(itrk);
+    double pz = data_tracks->get_pz(itrk);
+    tc.mom = data_tracks->get_mom(itrk);
+
+    tc.good = TMath::Finite(px+py+pz+tc.mom) &&
+      data_tracks->get_quality(itrk) > 3 &&
+      !dcdeadmap->IsDead(data_tracks, itrk);
+    if(tc.good)
+    {
+      TVector3 v3_track(px, py, pz);
+      tc.good = v3_track.Pt() >= epsilon;
+      if(tc.good)
+      {
+        TVector2 v2 = v3_track.EtaPhiVector();
+        tc.eta = v2.X();
+        tc.phi = v2.Y();
+      }
+    }
+  }
+
+  /* Cone distances and energy of each cluster in cone,
+   * the latter is subtracted for the pair partner */
+  vector<double> dr_clus(ncluster), dr_trk(npart), econe_clus(ncluster);
+
+  for(unsigned i=0; i<ncluster; i++)
+  {
+    const ClusterCache &c1 = cluster_cache[i];
+    if( !c1.photon || !c1.valid || c1.part < 0 || c1.charge_veto )
+      continue;
+
+    emcClusterContent *cluster1 = data_emccontainer->getCluster(i);
+    if( !emcwarnmap->InFiducial(cluster1) )
+      continue;
+
+    bool trig[3] = {};
+    for(int evtype=0; evtype<3; evtype++)
+      trig[evtype] = evtrig[evtype] &&
+        anatools::PassERT(data_ert, cluster1, (anatools::TriggerMode)evtype);
+    if( !trig[0] && !trig[1] && !trig[2] )
+      continue;
+
+    for(unsigned j=0; j<ncluster; j++)
+      if( j != i && cluster_cache[j].valid )
+      {
+        TVector2 v2_diff(cluster_cache[j].eta - c1.eta, cluster_cache[j].phi - c1.phi);
+        if( v2_diff.Y() > PI ) v2_diff -= v2_2PI;
+        else if( v2_diff.Y() < -PI ) v2_diff += v2_2PI;
+        dr_clus[j] = v2_diff.Mod();
+      }
+      else
+        dr_clus[j] = 2.*PI;
+
+    for(unsigned itrk=0; itrk<npart; itrk++)
+      if( track_cache[itrk].good )
+      {
+        TVector2 v2_diff(track_cache[itrk].eta - c1.eta, track_cache[itrk].phi - c1.phi);
+        if( v2_diff.Y() > PI ) v2_diff -= v2_2PI;
+        else if( v2_diff.Y() < -PI ) v2_diff += v2_2PI;
+        dr_trk[itrk] = v2_diff.Mod();
+      }
+      else
+        dr_trk[itrk] = 2.*PI;
+
+    for(unsigned ivar=0; ivar<nvariant; ivar++)
+    {
+      const unsigned bit = 1U << ivar;
+      if( !(c1.photon & bit) ) continue;
+      const CutVariant &cut = cutvariants[ivar];
+
+      /* Sum up energy in cone */
+      double econe = 0.;
+      for(unsigned j=0; j<ncluster; j++)
+      {
+        const ClusterCache &c2 = cluster_cache[j];
+        econe_clus[j] = 0.;
+        if( dr_clus[j] < cut.cone_angle &&
+            !c2.bad_tower && !c2.charge_veto &&
+            fabs(c2.tof) <= cut.tof_max_iso &&
+            c2.ecore >= cut.eclus_min )
+        {
+          econe_clus[j] = c2.ecore;
+          econe += c2.ecore;
+        }
+      }
+      for(unsigned itrk=0; itrk<npart; itrk++)
+      {
+        const TrackCache &tc = track_cache[itrk];
+        if( dr_trk[itrk] < cut.cone_angle &&
+            tc.mom >= cut.ptrk_min && tc.mom <= cut.ptrk_max )
+          econe += tc.mom;
+      }
+
+      int isolated = econe < cut.eratio * c1.ecore ? 1 : 0;
+
+      for(int evtype=0; evtype<3; evtype++)
+        if( trig[evtype] )
+        {
+          int ih = c1.part + 3*evtype + 3*3*isolated;
+          h_1photon_var[ih + nh_1photon_var*ivar]->Fill(c1.pT);
+        }
+
+      for(unsigned j=0; j<ncluster; j++)
+      {
+        const ClusterCache &c2 = cluster_cache[j];
+        if( j == i || !c2.good_tower || !(c2.photon & bit) )
+          continue;
+
+        emcClusterContent *cluster2 = data_emccontainer->getCluster(j);
+        double minv = anatools::GetInvMass(cluster1, cluster2);
+
+        int isopair = econe - econe_clus[j] < cut.eratio * c1.ecore ? 1 : 0;
+
+        for(int evtype=0; evtype<3; evtype++)
+          if( trig[evtype] )
+          {
+            int ih = c1.part + 3*evtype + 3*3*isolated + 3*3*2*isopair;
+            h2_2photon_var[ih + nh_2photon_var*ivar]->Fill(c1.pT, minv);
+          }
+      } // j loop
+    } // ivar
+  } // i loop
+
+  return EVENT_OK;
+}
+
 int PhotonHistos::End(PHCompositeNode *topNode)
 {
+  if(prof)
+    prof->Finish();
   hm->dumpHistos(outFile);
+  if(writeEmpty)
+  {
+    /* Empty histograms for members never filled, so the output layout does not depend on the data */
+    TFile *f = new TFile(outFile.c_str(), "UPDATE");
+    for(unsigned i=0; i<families.size(); i++)
+      families[i]->WriteEmpty();
+    f->Close();
+    delete f;
+  }
   delete hm;
   delete emcrecalib;
   delete emcrecalib_sasha;
   delete emcwarnmap;
   delete dcdeadmap;
   delete spinpattern;
+  delete prof;
 
   return EVENT_OK;
 }
@@ -1090,6 +1273,53 @@ void PhotonHistos::SelectERT()
   return;
 }
 
+void PhotonHistos::SetCutVariant(const string &variant, const string &cut, double value)
+{
+  if(hm)
+  {
+    cerr << "Cut variant " << variant << " must be set before Init" << endl;
+    exit(1);
+  }
+
+  /* New variant starts from the nominal cuts */
+  unsigned ivar = 0;
+  while( ivar < cutvariants.size() && cutvariants[ivar].name != variant )
+    ivar++;
+  if( ivar == cutvariants.size() )
+  {
+    if( ivar == max_cutvariants )
+    {
+      cerr << "Too many cut variants, at most " << max_cutvariants << endl;
+      exit(1);
+    }
+    CutVariant nominal = {variant, probMin, eClusMin, tofMaxIso, cone_angle, eratio, pTrkMin, pTrkMax};
+    cutvariants.push_back(nominal);
+  }
+
+  CutVariant &cutvar = cutvariants[ivar];
+  if( cut == "prob_min" )
+    cutvar.prob_min = value;
+  else if( cut == "eclus_min" )
+    cutvar.eclus_min = value;
+  else if( cut == "tof_max_iso" )
+    cutvar.tof_max_iso = value;
+  else if( cut == "cone_angle" )
+    cutvar.cone_angle = value;
+  else if( cut == "eratio" )
+    cutvar.eratio = value;
+  else if( cut == "ptrk_min" )
+    cutvar.ptrk_min = value;
+  else if( cut == "ptrk_max" )
+    cutvar.ptrk_max = value;
+  else
+  {
+    cerr << "Unknown cut " << cut << " for cut variant " << variant << endl;
+    exit(1);
+  }
+
+  return;
+}
+
 void PhotonHistos::BookHistograms()
 {
   /* Initialize histogram manager */
@@ -1156,90 +1386,65 @@ void PhotonHistos::BookHistograms()
   hm->registerHisto(h_events);
 
   // ih = sector + 8*raw < 8*2
-  for(int ih=0; ih<nh_calib; ih++)
-  {
-    /* ToF calibration */
-    h2_tof[ih] = new TH2F(Form("h2_tof_%d",ih), "ToF;p_{T} [GeV];tof [ns];", npT,pTbin, 500,-50.,50.);
-    hm->registerHisto(h2_tof[ih]);
-    /* Storing invariant mass of photon pairs in different sectors and pT bins.
-     * Require both photons to be in same sector.
-     * Used to check sector-by-sector EMCal energy calibration.
-     */
-    h2_minv[ih] = new TH2F(Form("h2_minv_%d",ih), "Photon pair invariant mass;p_{T} [GeV];m_{inv} [GeV];", npT,pTbin, 300,0.,0.3);
-    hm->registerHisto(h2_minv[ih]);
-  }
+  /* ToF calibration */
+  BookFamily(h2_tof, "h2_tof", nh_calib,
+      new TH2F("h2_tof", "ToF;p_{T} [GeV];tof [ns];", npT,pTbin, 500,-50.,50.));
+  /* Storing invariant mass of photon pairs in different sectors and pT bins.
+   * Require both photons to be in same sector.
+   * Used to check sector-by-sector EMCal energy calibration.
+   */
+  BookFamily(h2_minv, "h2_minv", nh_calib,
+      new TH2F("h2_minv", "Photon pair invariant mass;p_{T} [GeV];m_{inv} [GeV];", npT,pTbin, 300,0.,0.3));
 
   // ih = part + 3*bbc_trig < 3*2
-  for(int ih=0; ih<nh_bbc; ih++)
-  {
-    /* BBC trigger efficiency for photon */
-    h_bbc[ih] = new TH1F(Form("h_bbc_%d",ih), "BBC efficiency;p_{T} [GeV];", npT,pTbin);
-    hm->registerHisto(h_bbc[ih]);
-    /* BBC Trigger efficiency for pion */
-    h2_bbc_pion[ih] = new TH2F(Form("h2_bbc_pion_%d",ih), "BBC efficiency;p_{T} [GeV];m_{inv} [GeV];", npT,pTbin, 300,0.,0.3);
-    hm->registerHisto(h2_bbc_pion[ih]);
-    /* Store photon bg information */
-  }
+  /* BBC trigger efficiency for photon */
+  BookFamily(h_bbc, "h_bbc", nh_bbc,
+      new TH1F("h_bbc", "BBC efficiency;p_{T} [GeV];", npT,pTbin));
+  /* BBC Trigger efficiency for pion */
+  BookFamily(h2_bbc_pion, "h2_bbc_pion", nh_bbc,
+      new TH2F("h2_bbc_pion", "BBC efficiency;p_{T} [GeV];m_{inv} [GeV];", npT,pTbin, 300,0.,0.3));
 
   // ih = sector + 8*ert_trig[evtype] + 8*2*evtype < 8*2*3
-  for(int ih=0; ih<nh_ertsm; ih++)
-  {
-    /* ERT trigger efficiency for each of super modules */
-    h2_ertsm[ih] = new TH2F(Form("h2_ertsm_%d",ih), "ERT efficiency;p_{T} [GeV];SM;", npT,pTbin, 32,-0.5,31.5);
-    hm->registerHisto(h2_ertsm[ih]);
-  }
+  /* ERT trigger efficiency for each of super modules */
+  BookFamily(h2_ertsm, "h2_ertsm", nh_ertsm,
+      new TH2F("h2_ertsm", "ERT efficiency;p_{T} [GeV];SM;", npT,pTbin, 32,-0.5,31.5));
 
   // ih = part + 3*ert_trig[evtype] + 3*2*evtype + 3*2*3*checkmap + 3*2*3*2*isolated[ival] + 3*2*3*2*2*ival < 3*2*3*2*2*3
-  for(int ih=0; ih<nh_ert; ih++)
-  {
-    /* ERT trigger efficiency for photon */
-    h_ert[ih] = new TH1F(Form("h_ert_%d",ih), "ERT efficiency;p_{T} [GeV];", npT,pTbin);
-    hm->registerHisto(h_ert[ih]);
-    /* ERT Trigger efficiency for pion */
-    h2_ert_pion[ih] = new TH2F(Form("h2_ert_pion_%d",ih), "ERT efficiency;p_{T} [GeV];m_{inv} [GeV];", npT,pTbin, 300,0.,0.3);
-    hm->registerHisto(h2_ert_pion[ih]);
-  }
+  /* ERT trigger efficiency for photon */
+  BookFamily(h_ert, "h_ert", nh_ert,
+      new TH1F("h_ert", "ERT efficiency;p_{T} [GeV];", npT,pTbin));
+  /* ERT Trigger efficiency for pion */
+  BookFamily(h2_ert_pion, "h2_ert_pion", nh_ert,
+      new TH2F("h2_ert_pion", "ERT efficiency;p_{T} [GeV];m_{inv} [GeV];", npT,pTbin, 300,0.,0.3));
 
   /* Track quality study */
   // ih = dcns + 2*dcwe + 2*2*iqual < 2*2*3
-  for(int ih=0; ih<nh_dcpartqual; ih++)
-  {
-    h3_dcdphiz[ih] = new TH3F(Form("h3_dcdphiz_%d",ih), "EMCal and DC phi and z deviation;dphi [rad];dz [cm];mom [GeV];",
-        100,-0.1,0.1, 100,-50.,50., 30,0.,15.);
-    hm->registerHisto(h3_dcdphiz[ih]);
-    h2_alphaboard[ih] = new TH2F(Form("h2_alphaboard_%d",ih), "DC #alpha-board;board;#alpha;", 82*4,-1.5,80.5, 120,-0.6,0.6);
-    hm->registerHisto(h2_alphaboard[ih]);
-  }
+  BookFamily(h3_dcdphiz, "h3_dcdphiz", nh_dcpartqual,
+      new TH3F("h3_dcdphiz", "EMCal and DC phi and z deviation;dphi [rad];dz [cm];mom [GeV];",
+        100,-0.1,0.1, 100,-50.,50., 30,0.,15.));
+  BookFamily(h2_alphaboard, "h2_alphaboard", nh_dcpartqual,
+      new TH2F("h2_alphaboard", "DC #alpha-board;board;#alpha;", 82*4,-1.5,80.5, 120,-0.6,0.6));
 
   // ih = isGoodDC < 2
-  for(int ih=0; ih<nh_dcgood; ih++)
-  {
-    h3_dclive[ih] = new TH3F(Form("h3_dclive_%d",ih), "DC zed and phi distribution;zed [cm];phi [rad];mom [GeV];",
-        200,-100.,100., 50,-1.,4., 30,0.,15.);
-    hm->registerHisto(h3_dclive[ih]);
-  }
+  BookFamily(h3_dclive, "h3_dclive", nh_dcgood,
+      new TH3F("h3_dclive", "DC zed and phi distribution;zed [cm];phi [rad];mom [GeV];",
+        200,-100.,100., 50,-1.,4., 30,0.,15.));
 
   h_prod = new TH1F("h_prod", "Minus charge times pT times alpha;-charge*pT*#alpha [GeV]", 200,0.,0.2);
   hm->registerHisto(h_prod);
 
   /* Store pi0 information */
   // ih = part1 + 3*evtype + 3*3*tof + 3*3*2*prob + 3*3*2*2*checkmap + 3*3*2*2*2*isolated[ival] + 3*3*2*2*2*2*ival < 3*3*2*2*2*2*3
-  for(int ih=0; ih<nh_pion; ih++)
-  {
-    h2_pion[ih] = new TH2F(Form("h2_pion_%d",ih), "#pi^{0} spectrum;p_{T} [GeV];m_{inv} [GeV];", npT,pTbin, 300,0.,0.3);
-    hm->registerHisto(h2_pion[ih]);
-  }
+  BookFamily(h2_pion, "h2_pion", nh_pion,
+      new TH2F("h2_pion", "#pi^{0} spectrum;p_{T} [GeV];m_{inv} [GeV];", npT,pTbin, 300,0.,0.3));
 
   /* Store polarized pi0 information */
   // ih = beam + 3*evenodd + 3*2*pol < 3*2*2
-  for(int ih=0; ih<nh_pion_pol; ih++)
-  {
-    h2_pion_pol[ih] = new TH2F(Form("h2_pion_pol_%d",ih), "Polarized spectrum;p_{T} [GeV];m_{inv} [GeV];",
-        300,0.,30., 300,0.,0.3);
-    hm->registerHisto(h2_pion_pol[ih]);
-  }
+  BookFamily(h2_pion_pol, "h2_pion_pol", nh_pion_pol,
+      new TH2F("h2_pion_pol", "Polarized spectrum;p_{T} [GeV];m_{inv} [GeV];",
+        300,0.,30., 300,0.,0.3));
 
-  /* Eta and phi distribution */
+  /* Eta and phi distribution, binning depends on the part so booked directly */
   // ih = part + 3*checkmap + 3*2*isolated[ival] + 3*2*2*ival < 3*2*2*3
   for(int ih=0; ih<nh_eta_phi; ih++)
   {
@@ -1249,72 +1454,84 @@ void PhotonHistos::BookHistograms()
 
   /* Store single photon information */
   // ih = part + 3*evtype + 3*3*checkmap + 3*3*2*isolated[ival] + 3*3*2*2*ival < 3*3*2*2*3
-  for(int ih=0; ih<nh_1photon; ih++)
-  {
-    h_1photon[ih] = new TH1F(Form("h_1photon_%d",ih), "Single photon spectrum;p_{T} [GeV];", npT,pTbin);
-    hm->registerHisto(h_1photon[ih]);
-  }
+  BookFamily(h_1photon, "h_1photon", nh_1photon,
+      new TH1F("h_1photon", "Single photon spectrum;p_{T} [GeV];", npT,pTbin));
 
   /* Store polarized single photons information */
   // ih = beam + 3*evenodd + 3*2*pol + 3*2*2*checkmap + 3*2*2*2*isolated[1] + 3*2*2*2*2*ical < 3*2*2*2*2*2
-  for(int ih=0; ih<nh_1photon_pol; ih++)
-  {
-    h_1photon_pol[ih] = new TH1F(Form("h_1photon_pol_%d",ih), "Polarized single photon spectrum;p_{T} [GeV];", 300,0.,30.);
-    hm->registerHisto(h_1photon_pol[ih]);
-  }
+  BookFamily(h_1photon_pol, "h_1photon_pol", nh_1photon_pol,
+      new TH1F("h_1photon_pol", "Polarized single photon spectrum;p_{T} [GeV];", 300,0.,30.));
 
   /* Store two photons information */
   // ih = part + 3*evtype + 3*3*checkmap + 3*3*2*isolated[ival] + 3*3*2*2*isopair[ival] + 3*3*2*2*2*ival < 3*3*2*2*2*3
-  for(int ih=0; ih<nh_2photon; ih++)
-  {
-    h2_2photon[ih] = new TH2F(Form("h2_2photon_%d",ih), "Two photons spectrum;p_{T} [GeV];m_{inv} [GeV];", npT,pTbin, 300,0.,0.3);
-    h2_2photon2pt[ih] = (TH2*)h2_2photon[0]->Clone(Form("h2_2photon2pt_%d",ih));
-    hm->registerHisto(h2_2photon[ih]);
-    hm->registerHisto(h2_2photon2pt[ih]);
-  }
+  BookFamily(h2_2photon, "h2_2photon", nh_2photon,
+      new TH2F("h2_2photon", "Two photons spectrum;p_{T} [GeV];m_{inv} [GeV];", npT,pTbin, 300,0.,0.3));
+  BookFamily(h2_2photon2pt, "h2_2photon2pt", nh_2photon,
+      (TH2*)h2_2photon.GetPrototype()->Clone("h2_2photon2pt"));
 
   /* Store polarized two photons information */
   // ih = beam + 3*evenodd + 3*2*pol + 3*2*2*checkmap + 3*2*2*2*isolated[1] + 3*2*2*2*2*isopair[1] + 3*2*2*2*2*2*ical < 3*2*2*2*2*2*2
-  for(int ih=0; ih<nh_2photon_pol; ih++)
-  {
-    h2_2photon_pol[ih] = (TH2*)h2_pion_pol[0]->Clone(Form("h2_2photon_pol_%d",ih));
-    h2_2photon2pt_pol[ih] = (TH2*)h2_pion_pol[0]->Clone(Form("h2_2photon2pt_pol_%d",ih));
-    hm->registerHisto(h2_2photon_pol[ih]);
-    hm->registerHisto(h2_2photon2pt_pol[ih]);
-  }
+  BookFamily(h2_2photon_pol, "h2_2photon_pol", nh_2photon_pol,
+      (TH2*)h2_pion_pol.GetPrototype()->Clone("h2_2photon_pol"));
+  BookFamily(h2_2photon2pt_pol, "h2_2photon2pt_pol", nh_2photon_pol,
+      (TH2*)h2_pion_pol.GetPrototype()->Clone("h2_2photon2pt_pol"));
 
   /* Store pion event multiplicity information */
   // ih = beam + 3*evenodd < 3*2
-  for(int ih=0; ih<nh_mul_pion; ih++)
-  {
-    h2_mul_pion_sig[ih] = new TH2F(Form("h2_mul_pion_sig_%d",ih), "Event multiplity;p_{T} [GeV];Multiplicity;", npT_pol,pTbin_pol, 20,-0.5,19.5);
-    h2_mul_pion_bg[ih] = (TH2*)h2_mul_pion_sig[0]->Clone(Form("h2_mul_pion_bg_%d",ih));
-    hm->registerHisto(h2_mul_pion_sig[ih]);
-    hm->registerHisto(h2_mul_pion_bg[ih]);
-  }
+  BookFamily(h2_mul_pion_sig, "h2_mul_pion_sig", nh_mul_pion,
+      new TH2F("h2_mul_pion_sig", "Event multiplity;p_{T} [GeV];Multiplicity;", npT_pol,pTbin_pol, 20,-0.5,19.5));
+  BookFamily(h2_mul_pion_bg, "h2_mul_pion_bg", nh_mul_pion,
+      (TH2*)h2_mul_pion_sig.GetPrototype()->Clone("h2_mul_pion_bg"));
 
   /* Store isolated photon event multiplicity information */
   // ih = imul + 6*beam + 6*3*evenodd + 6*3*2*checkmap + 6*3*2*2*ical < 6*3*2*2*2
-  for(int ih=0; ih<nh_mul_photon; ih++)
-  {
-    h2_mul_photon[ih] = (TH2*)h2_mul_pion_sig[0]->Clone(Form("h2_mul_photon_%d",ih));
-    hm->registerHisto(h2_mul_photon[ih]);
-  }
+  BookFamily(h2_mul_photon, "h2_mul_photon", nh_mul_photon,
+      (TH2*)h2_mul_pion_sig.GetPrototype()->Clone("h2_mul_photon"));
 
-  /* Store polarized photon information for bunch shuffling */
+  /* Store polarized photon information for bunch shuffling.
+   * All bunches in one histogram with the index on the Y axis */
   // ih = imul + 6*evenodd + 6*2*(bunch/2) + 6*2*60*checkmap + 6*2*60*2*ical < 6*2*60*2*2
-  for(int ih=0; ih<nh_photon_bunch; ih++)
+  h2_photon_bunch = new TH2F("h2_photon_bunch", "Polarized photon spectrum;p_{T} [GeV];ih;",
+      npT_pol,pTbin_pol, nh_photon_bunch,-0.5,nh_photon_bunch-0.5);
+  h2_photon_bunch->Sumw2();
+  hm->registerHisto(h2_photon_bunch);
+
+  /* Store single and two photons information for cut variants */
+  // ih = part + 3*evtype + 3*3*isolated < 3*3*2
+  // ih = part + 3*evtype + 3*3*isolated + 3*3*2*isopair < 3*3*2*2
+  for(unsigned ivar=0; ivar<cutvariants.size(); ivar++)
   {
-    h_photon_bunch[ih] = new TH1F(Form("h_photon_bunch_%d",ih), "Polarized photon spectrum;p_{T} [GeV];", npT_pol,pTbin_pol);
-    hm->registerHisto(h_photon_bunch[ih]);
+    const char *name = cutvariants[ivar].name.c_str();
+    for(int ih=0; ih<nh_1photon_var; ih++)
+    {
+      TH1 *h = (TH1*)h_1photon.GetPrototype()->Clone(Form("h_1photon_%s_%d",name,ih));
+      h_1photon_var.push_back(h);
+      hm->registerHisto(h);
+    }
+    for(int ih=0; ih<nh_2photon_var; ih++)
+    {
+      TH2 *h2 = (TH2*)h2_2photon.GetPrototype()->Clone(Form("h2_2photon_%s_%d",name,ih));
+      h2_2photon_var.push_back(h2);
+      hm->registerHisto(h2);
+    }
   }
 
   return;
 }
 
+void PhotonHistos::BookFamily(HistogramFamilyBase &family, const char *name, unsigned n, TH1 *proto)
+{
+  family.Init(hm, name, n, proto);
+  families.push_back(&family);
+
+  return;
+}
+
 void PhotonHistos::SumEEmcal(const emcClusterContent *cluster, const emcClusterContainer *cluscont,
     const PHCentralTrack *data_tracks, double bbc_t0, double econe[])
 { 
+  PROFILE_STAGE(prof, kSumEEmcal);
+
   /* Sum up all energy in cone around particle without one cluster */
   for(int ival=0; ival<2; ival++)
     econe[ival] = 0.;
@@ -1362,6 +1579,8 @@ void PhotonHistos::SumEEmcal(const emcClusterContent *cluster, const emcClusterC
 void PhotonHistos::SumEEmcal(const emcClusterContent *cluster, const emcClusterContent *cluster_part,
     const emcClusterContainer *cluscont, const PHCentralTrack *data_tracks, double bbc_t0, double econe[])
 { 
+  PROFILE_STAGE(prof, kSumEEmcal);
+
   /* Sum up all energy in cone around particle without the partner cluster */
   for(int ival=0; ival<2; ival++)
     econe[ival] = 0.;
@@ -1409,6 +1628,8 @@ void PhotonHistos::SumEEmcal(const emcClusterContent *cluster, const emcClusterC
 
 void PhotonHistos::SumPTrack(const emcClusterContent *cluster, const PHCentralTrack *data_tracks, double econe[])
 { 
+  PROFILE_STAGE(prof, kSumPTrack);
+
   /* Sum up all energy in cone around particle */
   for(int ival=0; ival<3; ival++)
     econe[ival] = 0.;
@@ -1458,6 +1679,8 @@ void PhotonHistos::SumPTrack(const emcClusterContent *cluster, const PHCentralTr
 void PhotonHistos::SumEPi0(const emcClusterContent *cluster1, const emcClusterContent *cluster2,
     const emcClusterContainer *cluscont, const PHCentralTrack *data_tracks, double bbc_t0, double econe[])
 { 
+  PROFILE_STAGE(prof, kSumEPi0);
+
   /* Sum up all energy in cone around pi0 */
   double econeEM[2] = {};
   for(int ival=0; ival<3; ival++)
@@ -1603,6 +1826,8 @@ bool PhotonHistos::TestPhoton(const emcClusterContent *cluster, double bbc_t0)
 
 bool PhotonHistos::PassChargeVeto(const emcClusterContent *cluster)
 {
+  PROFILE_STAGE(prof, kChargeVeto);
+
   /* Angle between EMC cluster and PC3 track */
   double theta_cv = anatools::GetTheta_CV(cluster);
 
@@ -1643,75 +1868,12 @@ int PhotonHistos::GetPattern(int crossing)
   return pattern;
 }
 
-void PhotonHistos::UpdateSpinPattern(SpinDBContent &spin_cont)
+void PhotonHistos::UpdateSpinPattern(const SpinPattern &spin)
 {
-  /* Get spin info */
-  int runnumber = spin_cont.GetRunNumber();
-  int qa_level = spin_cont.GetQALevel();
-  int fillnumber = spin_cont.GetFillNumber();
-  int badrunqa = spin_cont.GetBadRunFlag();
-  int crossing_shift = spin_cont.GetCrossingShift();
-
-  double pb, pbstat, pbsyst;
-  double py, pystat, pysyst;
-
-  spin_cont.GetPolarizationBlue(1, pb, pbstat, pbsyst);
-  spin_cont.GetPolarizationYellow(1, py, pystat, pysyst);
-
-  int badbunch[120];
-  int spinpattern_blue[120];
-  int spinpattern_yellow[120];
-
-  long long bbc_narrow[120];
-  long long bbc_wide[120];
-  long long zdc_narrow[120];
-  long long zdc_wide[120];
-
-  for(int i=0; i<120; i++)
-  {
-    badbunch[i] = spin_cont.GetBadBunchFlag(i);
-    spinpattern_blue[i] = spin_cont.GetSpinPatternBlue(i);
-    spinpattern_yellow[i] = spin_cont.GetSpinPatternYellow(i);
-
-    bbc_narrow[i] = spin_cont.GetScalerBbcVertexCut(i);
-    bbc_wide[i] = spin_cont.GetScalerBbcNoCut(i);
-    zdc_narrow[i] = spin_cont.GetScalerZdcNarrow(i);
-    zdc_wide[i] = spin_cont.GetScalerZdcWide(i);
-  }
-
   /* Update spinpattern */
   int current_qa_level = spinpattern->get_qa_level();
-  if(current_qa_level < qa_level)
-  {
-    spinpattern->Reset();
-
-    spinpattern->set_runnumber(runnumber);
-    spinpattern->set_qa_level(qa_level);
-    spinpattern->set_fillnumber(fillnumber);
-    spinpattern->set_badrunqa(badrunqa);
-    spinpattern->set_crossing_shift(crossing_shift);
-
-    spinpattern->set_pb(pb);
-    spinpattern->set_pbstat(pbstat);
-    spinpattern->set_pbsyst(pbsyst);
-    spinpattern->set_py(py);
-    spinpattern->set_pystat(pystat);
-    spinpattern->set_pysyst(pysyst);
-
-    for(int i=0; i<120; i++)
-    {
-      spinpattern->set_badbunch(i, badbunch[i]);
-      spinpattern->set_spinpattern_blue(i, spinpattern_blue[i]);
-      spinpattern->set_spinpattern_yellow(i, spinpattern_yellow[i]);
-
-      /* For Run13, GL1p swap narrow and wide.
-       * So I swap narrow and wide to correct the error. */
-      spinpattern->set_bbc_narrow(i, bbc_wide[i]);
-      spinpattern->set_bbc_wide(i, bbc_narrow[i]);
-      spinpattern->set_zdc_narrow(i, zdc_wide[i]);
-      spinpattern->set_zdc_wide(i, zdc_narrow[i]);
-    }
-  }
+  if(current_qa_level < spin.get_qa_level())
+    *spinpattern = spin;
 
   return;
 }
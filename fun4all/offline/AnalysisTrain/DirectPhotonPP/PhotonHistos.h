@@ -1,15 +1,20 @@
 #ifndef __PHOTONHISTOS_H__
 #define __PHOTONHISTOS_H__
 
+#include "HistogramFamily.h"
+
 #include <SubsysReco.h>
 
+#include <string>
+#include <vector>
+
 class EmcLocalRecalibrator;
 class EmcLocalRecalibratorSasha;
 class EMCWarnmapChecker;
 class DCDeadmapChecker;
 
 class SpinPattern;
-class SpinDBContent;
+class StageProfiler;
 
 class PHGlobal;
 class PHCentralTrack;
@@ -40,6 +45,18 @@ class PhotonHistos: public SubsysReco
     void SelectMB();
     void SelectERT();
 
+    /* Evaluate a variation of the photon and isolation cuts in the same pass,
+     * filled to its own h_1photon_<variant>_* and h2_2photon_<variant>_* histograms.
+     * Cuts not set keep the nominal value, available cuts are
+     * prob_min, eclus_min, tof_max_iso, cone_angle, eratio, ptrk_min and ptrk_max.
+     * Must be called before Init. */
+    void SetCutVariant(const std::string &variant, const std::string &cut, double value);
+
+    /* Histogram arrays are booked on first fill. Members never filled are
+     * left out of the output by default, mergeHistos skips empty histograms
+     * anyway. Set to write them as empty placeholders for a fixed layout. */
+    void SetWriteEmpty(bool write_empty = true) { writeEmpty = write_empty; }
+
   protected:
     /* Number of histogram array */
     static const int nh_calib = 8*2;
@@ -58,6 +75,11 @@ class PhotonHistos: public SubsysReco
     static const int nh_2photon_pol = 3*2*2*2*2*2*2;
     static const int nh_mul_pion = 3*2;
     static const int nh_mul_photon = 6*3*2*2*2;
+    static const int nh_1photon_var = 3*3*2;
+    static const int nh_2photon_var = 3*3*2*2;
+
+    /* Maximum number of cut variants, one bit each in the pass masks */
+    static const unsigned max_cutvariants = 32;
 
     /* pT bins for ALL */
     static const int npT_pol = 15;
@@ -87,8 +109,13 @@ class PhotonHistos: public SubsysReco
     int FillPhotonSpectrum(const int ical, const emcClusterContainer *data_emccontainer, const PHCentralTrack *data_tracks,
         const PHGlobal *data_global, const TrigLvl1 *data_triggerlvl1, const ErtOut *data_ert);
 
+    /* Count direct photon yield for each cut variant */
+    int FillCutVariants(const emcClusterContainer *data_emccontainer, const PHCentralTrack *data_tracks,
+        const PHGlobal *data_global, const TrigLvl1 *data_triggerlvl1, const ErtOut *data_ert);
+
     /* Create histograms */
     void BookHistograms();
+    void BookFamily(HistogramFamilyBase &family, const char *name, unsigned n, TH1 *proto);
 
     /* Sum energy in cone around the reference particle
      * for isolated photon and isolated pair */
@@ -111,7 +138,44 @@ class PhotonHistos: public SubsysReco
     int GetPattern(int crossing);
 
     /* Update spin pattern information and store in class */
-    void UpdateSpinPattern(SpinDBContent &spin_cont);
+    void UpdateSpinPattern(const SpinPattern &spin);
+
+    /* Photon identification and isolation cuts of a cut variant */
+    struct CutVariant
+    {
+      std::string name;
+      double prob_min;
+      double eclus_min;
+      double tof_max_iso;
+      double cone_angle;
+      double eratio;
+      double ptrk_min;
+      double ptrk_max;
+    };
+
+    /* Cluster and track quantities computed once per event for all cut variants */
+    struct ClusterCache
+    {
+      double eta;
+      double phi;
+      double pT;
+      double ecore;
+      double tof;
+      double prob;
+      int part;
+      bool valid;
+      bool good_tower;
+      bool bad_tower;
+      bool charge_veto;
+      unsigned photon;  // bit ivar set if passing photon cuts of variant ivar
+    };
+    struct TrackCache
+    {
+      double eta;
+      double phi;
+      double mom;
+      bool good;
+    };
 
     enum DataType {MB, ERT};
     DataType datatype;
@@ -123,37 +187,49 @@ class PhotonHistos: public SubsysReco
     DCDeadmapChecker *dcdeadmap;
     SpinPattern *spinpattern;
 
+    /* Cut variants and their per-event caches */
+    std::vector<CutVariant> cutvariants;
+    std::vector<ClusterCache> cluster_cache;
+    std::vector<TrackCache> track_cache;
+
+    /* Per-stage timing, only created with DIRECTPHOTON_PROFILE */
+    StageProfiler *prof;
+
     int runnumber;
     int fillnumber;
 
     /* Output histograms */
     std::string outFile;
     Fun4AllHistoManager *hm;
+    bool writeEmpty;
+    std::vector<HistogramFamilyBase*> families;
     TH1 *h_events;
-    TH2 *h2_tof[nh_calib];
-    TH2 *h2_minv[nh_calib];
-    TH1 *h_bbc[nh_bbc];
-    TH2 *h2_bbc_pion[nh_bbc];
-    TH2 *h2_ertsm[nh_ertsm];
-    TH1 *h_ert[nh_ert];
-    TH2 *h2_ert_pion[nh_ert];
-    TH3 *h3_dcdphiz[nh_dcpartqual];
-    TH2 *h2_alphaboard[nh_dcpartqual];
-    TH3 *h3_dclive[nh_dcgood];
+    HistogramFamily<TH2> h2_tof;
+    HistogramFamily<TH2> h2_minv;
+    HistogramFamily<TH1> h_bbc;
+    HistogramFamily<TH2> h2_bbc_pion;
+    HistogramFamily<TH2> h2_ertsm;
+    HistogramFamily<TH1> h_ert;
+    HistogramFamily<TH2> h2_ert_pion;
+    HistogramFamily<TH3> h3_dcdphiz;
+    HistogramFamily<TH2> h2_alphaboard;
+    HistogramFamily<TH3> h3_dclive;
     TH1 *h_prod;
-    TH2 *h2_pion[nh_pion];
-    TH2 *h2_pion_pol[nh_pion_pol];
+    HistogramFamily<TH2> h2_pion;
+    HistogramFamily<TH2> h2_pion_pol;
     TH2 *h2_eta_phi[nh_eta_phi];
-    TH1 *h_1photon[nh_1photon];
-    TH1 *h_1photon_pol[nh_1photon_pol];
-    TH1 *h_photon_bunch[nh_photon_bunch];
-    TH2 *h2_2photon[nh_2photon];
-    TH2 *h2_2photon2pt[nh_2photon];
-    TH2 *h2_2photon_pol[nh_2photon_pol];
-    TH2 *h2_2photon2pt_pol[nh_2photon_pol];
-    TH2 *h2_mul_pion_sig[nh_mul_pion];
-    TH2 *h2_mul_pion_bg[nh_mul_pion];
-    TH2 *h2_mul_photon[nh_mul_photon];
+    HistogramFamily<TH1> h_1photon;
+    HistogramFamily<TH1> h_1photon_pol;
+    TH2 *h2_photon_bunch;
+    HistogramFamily<TH2> h2_2photon;
+    HistogramFamily<TH2> h2_2photon2pt;
+    HistogramFamily<TH2> h2_2photon_pol;
+    HistogramFamily<TH2> h2_2photon2pt_pol;
+    HistogramFamily<TH2> h2_mul_pion_sig;
+    HistogramFamily<TH2> h2_mul_pion_bg;
+    HistogramFamily<TH2> h2_mul_photon;
+    std::vector<TH1*> h_1photon_var;
+    std::vector<TH2*> h2_2photon_var;
 };
 
 #endif /* __PHOTONHISTOS_H__ */
@@ -7,13 +7,15 @@
 #include "EmcLocalRecalibratorSasha.h"
 #include "EMCWarnmapChecker.h"
 #include "PhotonContainer.h"
+#include "PhotonColumns.h"
+#include "PhotonEventTag.h"
 #include "Photon.h"
 #include "PhotonERT.h"
 #include "SpinPattern.h"
+#include "ConditionsCache.h"
+#include "StageProfiler.h"
 
 #include <RunHeader.h>
-#include <SpinDBOutput.hh>
-#include <SpinDBContent.hh>
 
 #include <PHGlobal.h>
 #include <TrigLvl1.h>
@@ -28,6 +30,7 @@
 
 #include <TOAD.h>
 #include <getClass.h>
+#include <Fun4AllHistoManager.h>
 #include <Fun4AllReturnCodes.h>
 
 #include <cstdlib>
@@ -40,13 +43,23 @@ using namespace std;
 
 const double PI = TMath::Pi();
 
+// stages for profiling
+enum ProfileStage {kEvent, kClone, kRecalib, kPhotons, kColumns, kTag, kClusters, kAccepted, nProfileStage};
+const char *const profile_stages[nProfileStage] = {"event", "clone", "recalib", "photons", "columns", "tag",
+  "clusters", "accepted"};
+
 PhotonNode::PhotonNode(const string &name) :
   SubsysReco(name),
   emcrecalib(nullptr),
   emcrecalib_sasha(nullptr),
   emcwarnmap(nullptr),
   photoncont(nullptr),
+  photoncols(nullptr),
+  packcols(false),
+  photontag(nullptr),
   spinpattern(nullptr),
+  prof(nullptr),
+  hm_prof(nullptr),
   runnumber(0),
   fillnumber(0)
 {
@@ -68,14 +81,39 @@ int PhotonNode::Init(PHCompositeNode *topNode)
   }
 
   photoncont = new PhotonContainer();
-  PHIODataNode<PHObject> *photonNode = new PHIODataNode<PHObject>(photoncont, "PhotonContainer", "PHObject");
-  if(!photoncont || !photonNode)
+  if(!photoncont)
+  {
+    cerr << "Failure to create photon container" << endl;
+    exit(1);
+  }
+
+  PHIODataNode<PHObject> *photonNode = nullptr;
+  if(photoncols)
+  {
+    photoncols->SetPacked(packcols);
+    photonNode = new PHIODataNode<PHObject>(photoncols, "PhotonColumns", "PHObject");
+  }
+  else
+  {
+    photonNode = new PHIODataNode<PHObject>(photoncont, "PhotonContainer", "PHObject");
+  }
+  if(!photonNode)
   {
     cerr << "Failure to create photon node" << endl;
     exit(1);
   }
   dstNode->addNode(photonNode);
 
+  // event tag for pre-selection without reading photons
+  photontag = new PhotonEventTag();
+  PHIODataNode<PHObject> *tagNode = new PHIODataNode<PHObject>(photontag, "PhotonEventTag", "PHObject");
+  if(!photontag || !tagNode)
+  {
+    cerr << "Failure to create photon tag node" << endl;
+    exit(1);
+  }
+  dstNode->addNode(tagNode);
+
   PHCompositeNode *runNode = dynamic_cast<PHCompositeNode*>( mainIter.findFirst("PHCompositeNode", "RUN") );
   if(!runNode)
   {
@@ -115,6 +153,13 @@ int PhotonNode::Init(PHCompositeNode *topNode)
     exit(1);
   }
 
+#ifdef DIRECTPHOTON_PROFILE
+  // per-stage timing goes to its own file as the output is a DST
+  hm_prof = new Fun4AllHistoManager("PhotonNodeProfile");
+  prof = new StageProfiler( "PhotonNode", vector<string>(profile_stages, profile_stages+nProfileStage) );
+  prof->BookHistograms(hm_prof);
+#endif
+
   return EVENT_OK;
 }
 
@@ -129,28 +174,17 @@ int PhotonNode::InitRun(PHCompositeNode *topNode)
   }
   runnumber = runheader->get_RunNumber();
 
-  SpinDBOutput spin_out;
-  SpinDBContent spin_cont;
-
-  // initialize object to access spin DB
-  spin_out.Initialize();
-  spin_out.SetUserName("phnxrc");
-  spin_out.SetTableName("spin");
-
-  // retrieve entry from Spin DB and get fill number
-  int qa_level = spin_out.GetDefaultQA(runnumber);
-  spin_out.StoreDBContent(runnumber, runnumber, qa_level);
-  spin_out.GetDBContentStore(spin_cont, runnumber);
-  fillnumber = spin_cont.GetFillNumber();
+  // spin DB entry and fill number, cached or prefetched for all runs
+  const RunConditions &cond = ConditionsCache::instance()->Get(runnumber);
+  fillnumber = cond.fillnumber;
 
   // load EMCal recalibrations for run and fill
   emcrecalib->ReadEnergyCorrection( runnumber );
   emcrecalib->ReadTofCorrection( fillnumber );
 
   // update spinpattern
-  if( spin_out.CheckRunRow(runnumber,qa_level) == 1 &&
-      spin_cont.GetRunNumber() == runnumber )
-    UpdateSpinPattern(spin_cont);
+  if( cond.spin_ok )
+    UpdateSpinPattern(cond.spinpattern);
   else
     spinpattern->Reset();
 
@@ -159,6 +193,8 @@ int PhotonNode::InitRun(PHCompositeNode *topNode)
 
 int PhotonNode::process_event(PHCompositeNode *topNode)
 {
+  PROFILE_STAGE(prof, kEvent);
+
   PHGlobal *data_global = findNode::getClass<PHGlobal>(topNode, "PHGlobal");
   TrigLvl1 *data_triggerlvl1 = findNode::getClass<TrigLvl1>(topNode, "TrigLvl1");
   ErtOut *data_ert = findNode::getClass<ErtOut>(topNode, "ErtOut");
@@ -204,6 +240,10 @@ int PhotonNode::process_event(PHCompositeNode *topNode)
   unsigned lvl1_scaled = data_triggerlvl1->get_lvl1_trigscaled();
   if( (lvl1_live & bit_ppg) || (lvl1_scaled & bit_ppg) ) return DISCARDEVENT;
 
+  // photon container is not on the node tree for column format
+  if(photoncols)
+    photoncont->Reset();
+
   // fill photon node
   photoncont->set_bbc_z(bbc_z);
   photoncont->set_bbc_t0(bbc_t0);
@@ -213,14 +253,30 @@ int PhotonNode::process_event(PHCompositeNode *topNode)
   if( datatype == ERT && !photoncont->get_ert_b_scaled() && fabs(bbc_z) > 30. )
     return DISCARDEVENT;
   else if( datatype == MB && fabs(bbc_z) > 30. )
+  {
+    if(photoncols)
+      photoncols->Fill(photoncont);
+    photontag->Fill(photoncont);
     return EVENT_OK;
+  }
+
+  PROFILE_MULTIPLICITY(prof, data_emccontainer_raw->size());
+  PROFILE_COUNT(prof, kClusters, data_emccontainer_raw->size());
 
   // Run local recalibration of EMCal cluster data
-  emcClusterContainer *data_emccontainer = data_emccontainer_raw->clone();
-  //emcrecalib->ApplyClusterCorrection( data_emccontainer );
-  emcrecalib_sasha->ApplyClusterCorrection( runnumber, data_emccontainer );
+  emcClusterContainer *data_emccontainer = nullptr;
+  {
+    PROFILE_STAGE(prof, kClone);
+    data_emccontainer = data_emccontainer_raw->clone();
+  }
+  {
+    PROFILE_STAGE(prof, kRecalib);
+    //emcrecalib->ApplyClusterCorrection( data_emccontainer );
+    emcrecalib_sasha->ApplyClusterCorrection( runnumber, data_emccontainer );
+  }
 
   int nemccluster = data_emccontainer->size();
+  PROFILE_START(prof, kPhotons);
   for(int iclus=0; iclus<nemccluster; iclus++)
   {
     emcClusterContent *emccluster_raw = data_emccontainer_raw->getCluster(iclus);
@@ -259,6 +315,22 @@ int PhotonNode::process_event(PHCompositeNode *topNode)
     }
   }
 
+  PROFILE_STOP(prof, kPhotons);
+  PROFILE_COUNT(prof, kAccepted, photoncont->Size());
+
+  // copy photons to column format
+  if(photoncols)
+  {
+    PROFILE_STAGE(prof, kColumns);
+    photoncols->Fill(photoncont);
+  }
+
+  // summarize event for tag stream
+  {
+    PROFILE_STAGE(prof, kTag);
+    photontag->Fill(photoncont);
+  }
+
   // clean up
   delete data_emccontainer;
 
@@ -267,10 +339,22 @@ int PhotonNode::process_event(PHCompositeNode *topNode)
 
 int PhotonNode::End(PHCompositeNode *topNode)
 {
+  if(prof)
+  {
+    prof->Finish();
+    hm_prof->dumpHistos("PhotonNode-profile.root");
+    delete hm_prof;
+    delete prof;
+  }
+
   delete emcrecalib;
   delete emcrecalib_sasha;
   delete emcwarnmap;
 
+  // photon container is only owned by the node tree in object format
+  if(photoncols)
+    delete photoncont;
+
   return EVENT_OK;
 }
 
@@ -286,6 +370,14 @@ void PhotonNode::SelectERT()
   return;
 }
 
+void PhotonNode::SelectColumnFormat(bool packed)
+{
+  if(!photoncols)
+    photoncols = new PhotonColumns();
+  packcols = packed;
+  return;
+}
+
 bool PhotonNode::TestPhoton(const emcClusterContent *emccluster, float bbc_t0)
 {
   if( emccluster->ecore() > 0.3 &&
@@ -359,75 +451,12 @@ float PhotonNode::GetTrackConeEnergy(const PHCentralTrack *tracks, const emcClus
   return cone_energy;
 }
 
-void PhotonNode::UpdateSpinPattern(SpinDBContent &spin_cont)
+void PhotonNode::UpdateSpinPattern(const SpinPattern &spin)
 {
-  // get spin info
-  int runnumber = spin_cont.GetRunNumber();
-  int qa_level = spin_cont.GetQALevel();
-  int fillnumber = spin_cont.GetFillNumber();
-  int badrunqa = spin_cont.GetBadRunFlag();
-  int crossing_shift = spin_cont.GetCrossingShift();
-
-  float pb, pbstat, pbsyst;
-  float py, pystat, pysyst;
-
-  spin_cont.GetPolarizationBlue(1, pb, pbstat, pbsyst);
-  spin_cont.GetPolarizationYellow(1, py, pystat, pysyst);
-
-  int badbunch[120];
-  int spinpattern_blue[120];
-  int spinpattern_yellow[120];
-
-  long long bbc_narrow[120];
-  long long bbc_wide[120];
-  long long zdc_narrow[120];
-  long long zdc_wide[120];
-
-  for(int i=0; i<120; i++)
-  {
-    badbunch[i] = spin_cont.GetBadBunchFlag(i);
-    spinpattern_blue[i] = spin_cont.GetSpinPatternBlue(i);
-    spinpattern_yellow[i] = spin_cont.GetSpinPatternYellow(i);
-
-    bbc_narrow[i] = spin_cont.GetScalerBbcVertexCut(i);
-    bbc_wide[i] = spin_cont.GetScalerBbcNoCut(i);
-    zdc_narrow[i] = spin_cont.GetScalerZdcNarrow(i);
-    zdc_wide[i] = spin_cont.GetScalerZdcWide(i);
-  }
-
   // update spinpattern
   int current_qa_level = spinpattern->get_qa_level();
-  if(current_qa_level < qa_level)
-  {
-    spinpattern->Reset();
-
-    spinpattern->set_runnumber(runnumber);
-    spinpattern->set_qa_level(qa_level);
-    spinpattern->set_fillnumber(fillnumber);
-    spinpattern->set_badrunqa(badrunqa);
-    spinpattern->set_crossing_shift(crossing_shift);
-
-    spinpattern->set_pb(pb);
-    spinpattern->set_pbstat(pbstat);
-    spinpattern->set_pbsyst(pbsyst);
-    spinpattern->set_py(py);
-    spinpattern->set_pystat(pystat);
-    spinpattern->set_pysyst(pysyst);
-
-    for(int i=0; i<120; i++)
-    {
-      spinpattern->set_badbunch(i, badbunch[i]);
-      spinpattern->set_spinpattern_blue(i, spinpattern_blue[i]);
-      spinpattern->set_spinpattern_yellow(i, spinpattern_yellow[i]);
-
-      /* For Run13, GL1p swap narrow and wide.
-       * So I swap narrow and wide to correct the error. */
-      spinpattern->set_bbc_narrow(i, bbc_wide[i]);
-      spinpattern->set_bbc_wide(i, bbc_narrow[i]);
-      spinpattern->set_zdc_narrow(i, zdc_wide[i]);
-      spinpattern->set_zdc_wide(i, zdc_narrow[i]);
-    }
-  }
+  if(current_qa_level < spin.get_qa_level())
+    *spinpattern = spin;
 
   return;
 }
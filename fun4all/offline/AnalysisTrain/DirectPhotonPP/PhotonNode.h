@@ -7,11 +7,14 @@ class EmcLocalRecalibrator;
 class EmcLocalRecalibratorSasha;
 class EMCWarnmapChecker;
 class PhotonContainer;
+class PhotonColumns;
+class PhotonEventTag;
 class SpinPattern;
-class SpinDBContent;
+class StageProfiler;
 class emcClusterContent;
 class PHCentralTrack;
 class PHCompositeNode;
+class Fun4AllHistoManager;
 
 class PhotonNode: public SubsysReco
 {
@@ -27,12 +30,16 @@ class PhotonNode: public SubsysReco
     void SelectMB();
     void SelectERT();
 
+    /* Write column-oriented PhotonColumns node instead of PhotonContainer,
+     * optionally with packed positions and ToF */
+    void SelectColumnFormat(bool packed = false);
+
   protected:
     bool TestPhoton(const emcClusterContent *emccluster, float bbc_t0);
     bool DispCut(const emcClusterContent *emccluster);
     float GetTrackConeEnergy(const PHCentralTrack *tracks, const emcClusterContent *cluster, double cone_angle);
 
-    void UpdateSpinPattern(SpinDBContent &spin_cont);
+    void UpdateSpinPattern(const SpinPattern &spin);
 
     enum DataType {MB, ERT};
     DataType datatype;
@@ -41,8 +48,15 @@ class PhotonNode: public SubsysReco
     EmcLocalRecalibratorSasha *emcrecalib_sasha;
     EMCWarnmapChecker *emcwarnmap;
     PhotonContainer *photoncont;
+    PhotonColumns *photoncols;
+    bool packcols;
+    PhotonEventTag *photontag;
     SpinPattern *spinpattern;
 
+    // per-stage timing, only created with DIRECTPHOTON_PROFILE
+    StageProfiler *prof;
+    Fun4AllHistoManager *hm_prof;
+
     int runnumber;
     int fillnumber;
 };
@@ -0,0 +1,76 @@
+#include "StageProfiler.h"
+
+#include <Fun4AllHistoManager.h>
+
+#include <TH1.h>
+#include <TH2.h>
+
+#include <algorithm>
+
+using namespace std;
+
+StageProfiler::StageProfiler(const string &a_name, const vector<string> &a_stages) :
+  name(a_name),
+  stages(a_stages),
+  start(a_stages.size()),
+  elapsed(a_stages.size(), Clock::duration::zero()),
+  calls(a_stages.size(), 0),
+  multiplicity(0),
+  h_time(nullptr),
+  h_calls(nullptr),
+  h2_event(nullptr)
+{
+}
+
+void StageProfiler::EndEvent(Clock::duration event_time)
+{
+  if(h2_event)
+    h2_event->Fill( multiplicity, chrono::duration<double, micro>(event_time).count() );
+
+  return;
+}
+
+void StageProfiler::BookHistograms(Fun4AllHistoManager *hm)
+{
+  int nstages = stages.size();
+  string prefix = "h_prof_" + name;
+
+  h_time = new TH1D( (prefix + "_time").c_str(), "Wall time per stage;;t [s]", nstages, -0.5, nstages-0.5 );
+  h_calls = new TH1D( (prefix + "_calls").c_str(), "Calls per stage;;calls", nstages, -0.5, nstages-0.5 );
+  for(int i=0; i<nstages; i++)
+  {
+    h_time->GetXaxis()->SetBinLabel(i+1, stages[i].c_str());
+    h_calls->GetXaxis()->SetBinLabel(i+1, stages[i].c_str());
+  }
+
+  h2_event = new TH2D( ("h2_prof_" + name + "_event").c_str(), "Event time;multiplicity;t [#mus]",
+      100, 0., 100., 200, 0., 10000. );
+
+  hm->registerHisto(h_time);
+  hm->registerHisto(h_calls);
+  hm->registerHisto(h2_event);
+
+  return;
+}
+
+void StageProfiler::Finish()
+{
+  if( !h_time || !h_calls ) return;
+
+  int nstages = stages.size();
+  for(int i=0; i<nstages; i++)
+  {
+    h_time->SetBinContent( i+1, chrono::duration<double>(elapsed[i]).count() );
+    h_calls->SetBinContent( i+1, calls[i] );
+  }
+
+  return;
+}
+
+void StageProfiler::Reset()
+{
+  fill(elapsed.begin(), elapsed.end(), Clock::duration::zero());
+  fill(calls.begin(), calls.end(), 0);
+
+  return;
+}
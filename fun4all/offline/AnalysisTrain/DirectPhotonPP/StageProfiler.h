@@ -0,0 +1,91 @@
+#ifndef __STAGEPROFILER_H__
+#define __STAGEPROFILER_H__
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+class Fun4AllHistoManager;
+class TH1;
+class TH2;
+
+/* Accumulate wall time and call counts of the processing stages of a module.
+ * Stage 0 is the whole event, its time is filled per event versus the event
+ * multiplicity given to SetMultiplicity(). Results are stored in histograms named
+ * h_prof_<name>_* registered to the module's histogram manager. Stage times
+ * are inclusive, so nested stages are also contained in their caller.
+ *
+ * Use the PROFILE_* macros in the modules, they compile to nothing unless
+ * the package is configured with --enable-profile (DIRECTPHOTON_PROFILE). */
+class StageProfiler
+{
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    StageProfiler(const std::string &name, const std::vector<std::string> &stages);
+    ~StageProfiler() {}
+
+    void Start(unsigned stage) { start[stage] = Clock::now(); }
+    void Stop(unsigned stage)
+    {
+      Clock::duration dt = Clock::now() - start[stage];
+      elapsed[stage] += dt;
+      calls[stage]++;
+      if(stage == 0) EndEvent(dt);
+    }
+    void Count(unsigned stage, unsigned long n = 1) { calls[stage] += n; }
+
+    void SetMultiplicity(unsigned a_multiplicity) { multiplicity = a_multiplicity; }
+
+    void BookHistograms(Fun4AllHistoManager *hm);
+
+    /* Copy accumulated results to histograms before they are written */
+    void Finish();
+
+    /* Clear accumulated results, e.g. for a new run */
+    void Reset();
+
+    class Scope
+    {
+      public:
+        Scope(StageProfiler *a_prof, unsigned a_stage): prof(a_prof), stage(a_stage) { if(prof) prof->Start(stage); }
+        ~Scope() { if(prof) prof->Stop(stage); }
+      private:
+        StageProfiler *prof;
+        unsigned stage;
+    };
+
+  protected:
+    void EndEvent(Clock::duration event_time);
+
+    std::string name;
+    std::vector<std::string> stages;
+
+    std::vector<Clock::time_point> start;
+    std::vector<Clock::duration> elapsed;
+    std::vector<unsigned long> calls;
+    unsigned multiplicity;
+
+    TH1 *h_time;
+    TH1 *h_calls;
+    TH2 *h2_event;
+};
+
+#define PROFILE_CAT(a, b) a##b
+#define PROFILE_NAME(line) PROFILE_CAT(profile_scope_, line)
+
+#ifdef DIRECTPHOTON_PROFILE
+#define PROFILE_STAGE(prof, stage) StageProfiler::Scope PROFILE_NAME(__LINE__)(prof, stage)
+#define PROFILE_START(prof, stage) do { if(prof) (prof)->Start(stage); } while(0)
+#define PROFILE_STOP(prof, stage) do { if(prof) (prof)->Stop(stage); } while(0)
+#define PROFILE_COUNT(prof, stage, n) do { if(prof) (prof)->Count(stage, n); } while(0)
+#define PROFILE_MULTIPLICITY(prof, mul) do { if(prof) (prof)->SetMultiplicity(mul); } while(0)
+#else
+#define PROFILE_STAGE(prof, stage) do {} while(0)
+#define PROFILE_START(prof, stage) do {} while(0)
+#define PROFILE_STOP(prof, stage) do {} while(0)
+#define PROFILE_COUNT(prof, stage, n) do {} while(0)
+#define PROFILE_MULTIPLICITY(prof, mul) do {} while(0)
+#endif
+
+#endif /* __STAGEPROFILER_H__ */
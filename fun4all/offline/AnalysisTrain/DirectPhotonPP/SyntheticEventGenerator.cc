@@ -0,0 +1,218 @@
+#include "SyntheticEventGenerator.h"
+
+#include "AnaToolsCluster.h"
+
+#include <RunHeaderv3.h>
+#include <PHGlobalv9.h>
+#include <TrigLvl1v1.h>
+#include <ErtOutv1.h>
+#include <emcClusterContainerv6.h>
+#include <emcClusterContent.h>
+#include <emcTowerContainerv3.h>
+#include <PHCentralTrackv24.h>
+
+#include <PHCompositeNode.h>
+#include <PHIODataNode.h>
+#include <PHNodeIterator.h>
+
+#include <Fun4AllReturnCodes.h>
+
+#include <TMath.h>
+#include <TRandom3.h>
+
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+/* EMCal geometry used to place the clusters */
+const double DEG = TMath::DegToRad();
+const double phi_west = -33.75*DEG;
+const double phi_east = 213.75*DEG;
+const double dphi_sector = 22.5*DEG;
+const double zlength = 400.;
+
+/* Triger bit */
+const unsigned bit_ert4x4[3] = {0x00000080, 0x00000040, 0x00000100};  // ert4x4a/b/c
+
+SyntheticEventGenerator::SyntheticEventGenerator(const string &name) :
+  SubsysReco(name),
+  seed(4357),
+  runnumber(0),
+  nclusters(20.),
+  ntracks(5.),
+  eslope(0.5),
+  ert_prob(0.5),
+  bbc_z_sigma(30.),
+  trig(0x00000012),
+  rnd(nullptr),
+  runheader(nullptr),
+  data_global(nullptr),
+  data_triggerlvl1(nullptr),
+  data_ert(nullptr),
+  data_emccontainer(nullptr),
+  data_emctwrcontainer(nullptr),
+  data_tracks(nullptr)
+{
+}
+
+SyntheticEventGenerator::~SyntheticEventGenerator()
+{
+  delete rnd;
+}
+
+int SyntheticEventGenerator::Init(PHCompositeNode *topNode)
+{
+  PHNodeIterator mainIter(topNode);
+  PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode*>( mainIter.findFirst("PHCompositeNode", "DST") );
+  PHCompositeNode *runNode = dynamic_cast<PHCompositeNode*>( mainIter.findFirst("PHCompositeNode", "RUN") );
+  if(!dstNode || !runNode)
+  {
+    cerr << "No DST or RUN node" << endl;
+    exit(1);
+  }
+
+  rnd = new TRandom3(seed);
+
+  runheader = new RunHeaderv3();
+  runheader->set_RunNumber(runnumber);
+  runNode->addNode( new PHIODataNode<PHObject>(runheader, "RunHeader", "PHObject") );
+
+  data_global = new PHGlobalv9();
+  data_triggerlvl1 = new TrigLvl1v1();
+  data_ert = new ErtOutv1();
+  data_emccontainer = new emcClusterContainerv6();
+  data_emctwrcontainer = new emcTowerContainerv3();
+  data_tracks = new PHCentralTrackv24();
+
+  dstNode->addNode( new PHIODataNode<PHObject>(data_global, "PHGlobal", "PHObject") );
+  dstNode->addNode( new PHIODataNode<PHObject>(data_triggerlvl1, "TrigLvl1", "PHObject") );
+  dstNode->addNode( new PHIODataNode<PHObject>(data_ert, "ErtOut", "PHObject") );
+  dstNode->addNode( new PHIODataNode<PHObject>(data_emccontainer, "emcClusterContainer", "PHObject") );
+  dstNode->addNode( new PHIODataNode<PHObject>(data_emctwrcontainer, "emcHitContainer", "PHObject") );
+  dstNode->addNode( new PHIODataNode<PHObject>(data_tracks, "PHCentralTrack", "PHObject") );
+
+  return EVENT_OK;
+}
+
+int SyntheticEventGenerator::process_event(PHCompositeNode *topNode)
+{
+  data_global->Reset();
+  data_triggerlvl1->Reset();
+  data_ert->Reset();
+  data_emccontainer->Reset();
+  data_tracks->Reset();
+
+  data_global->setBbcZVertex( rnd->Gaus(0., bbc_z_sigma) );
+  data_global->setBbcTimeZero( rnd->Gaus(0., 0.3) );
+
+  FillClusters();
+  FillTracks();
+  FillTrigger();
+
+  return EVENT_OK;
+}
+
+void SyntheticEventGenerator::FillClusters()
+{
+  int ncluster = rnd->Poisson(nclusters);
+
+  for(int i=0; i<ncluster; i++)
+  {
+    /* Sector counts west from bottom to top, then east from top to bottom */
+    int sector = rnd->Integer(8);
+    int arm = sector < 4 ? 0 : 1;
+    int rawsector = arm == 0 ? sector : 7 - sector;
+    int ny = sector < 6 ? 36 : 48;
+    int nz = sector < 6 ? 72 : 96;
+    double radius = sector < 6 ? 510. : 540.;
+
+    int iypos = rnd->Integer(ny);
+    int izpos = rnd->Integer(nz);
+
+    double phi = arm == 0 ?
+      phi_west + ( rawsector + (iypos+0.5)/ny ) * dphi_sector :
+      phi_east - ( rawsector + (iypos+0.5)/ny ) * dphi_sector;
+    double x = radius * cos(phi);
+    double y = radius * sin(phi);
+    double z = ( (izpos+0.5)/nz - 0.5 ) * zlength;
+
+    double ecore = 0.1 + rnd->Exp(eslope);
+
+    emcClusterContent *cluster = data_emccontainer->addCluster(i);
+    cluster->set_id(i);
+    cluster->set_arm(arm);
+    cluster->set_sector(rawsector);
+    cluster->set_ipos(iypos, izpos);
+    cluster->set_xyz(x, y, z);
+    cluster->set_theta( atan2(radius, z) );
+    cluster->set_phi(phi);
+    cluster->set_energy( ecore * 1.1 );
+    cluster->set_ecore(ecore);
+    cluster->set_tofcorr( data_global->getBbcTimeZero() + rnd->Gaus(0., 2.) );
+    cluster->set_prob_photon( rnd->Rndm() );
+    cluster->set_emcpc3dphi( rnd->Rndm() < 0.2 ? rnd->Gaus(0., 0.02) : 9999. );
+    cluster->set_emcpc3dz( rnd->Gaus(0., 5.) );
+    cluster->set_corrdisp( rnd->Exp(1.), rnd->Exp(1.) );
+  }
+
+  return;
+}
+
+void SyntheticEventGenerator::FillTracks()
+{
+  unsigned npart = rnd->Poisson(ntracks);
+  data_tracks->set_npart(npart);
+
+  for(unsigned i=0; i<npart; i++)
+  {
+    int arm = rnd->Integer(2);
+    double phi0 = arm == 0 ?
+      phi_west + rnd->Rndm() * 4. * dphi_sector :
+      phi_east - rnd->Rndm() * 4. * dphi_sector;
+    double the0 = TMath::PiOver2() + rnd->Uniform(-0.35, 0.35);
+    double mom = 0.2 + rnd->Exp(eslope);
+
+    data_tracks->AddPHParticle(i);
+    data_tracks->set_mom(i, mom);
+    data_tracks->set_the0(i, the0);
+    data_tracks->set_phi0(i, phi0);
+    data_tracks->set_charge(i, rnd->Rndm() < 0.5 ? -1 : 1);
+    data_tracks->set_quality(i, 63);
+    data_tracks->set_dcarm(i, arm);
+    data_tracks->set_alpha(i, rnd->Gaus(0., 0.1));
+    data_tracks->set_phi(i, phi0);
+    data_tracks->set_zed(i, rnd->Uniform(-75., 75.));
+    data_tracks->set_pemcx(i, 510. * cos(phi0));
+    data_tracks->set_pemcy(i, 510. * sin(phi0));
+    data_tracks->set_pemcz(i, 510. / tan(the0));
+    data_tracks->set_emcdphi(i, rnd->Gaus(0., 0.02));
+    data_tracks->set_emcdz(i, rnd->Gaus(0., 5.));
+  }
+
+  return;
+}
+
+void SyntheticEventGenerator::FillTrigger()
+{
+  unsigned lvl1_trig = trig;
+
+  /* Let each ERT 4x4 trigger fire on the supermodule of a random cluster */
+  unsigned ncluster = data_emccontainer->size();
+  if( ncluster > 0 )
+    for(int mode=0; mode<3; mode++)
+      if( rnd->Rndm() < ert_prob )
+      {
+        emcClusterContent *cluster = data_emccontainer->getCluster( rnd->Integer(ncluster) );
+        data_ert->set_ERTbit( mode, cluster->arm(), cluster->sector(), anatools::GetSM(cluster) );
+        lvl1_trig |= bit_ert4x4[mode];
+      }
+
+  data_triggerlvl1->set_lvl1_trigraw(lvl1_trig);
+  data_triggerlvl1->set_lvl1_triglive(lvl1_trig);
+  data_triggerlvl1->set_lvl1_trigscaled(lvl1_trig);
+  data_triggerlvl1->set_lvl1_clock_cross( rnd->Integer(120) );
+
+  return;
+}
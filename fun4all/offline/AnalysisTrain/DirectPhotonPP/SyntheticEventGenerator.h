@@ -0,0 +1,66 @@
+#ifndef __SYNTHETICEVENTGENERATOR_H__
+#define __SYNTHETICEVENTGENERATOR_H__
+
+#include <SubsysReco.h>
+
+class PHGlobal;
+class TrigLvl1;
+class ErtOut;
+class emcClusterContainer;
+class emcTowerContainer;
+class PHCentralTrack;
+class RunHeader;
+class PHCompositeNode;
+class TRandom3;
+
+/* Fill the DST nodes read by PhotonHistos and DirectPhotonPP with synthetic
+ * events, so the analysis modules can be run without any input file.
+ * Cluster and track multiplicities are Poisson distributed around the set
+ * mean, cluster energies follow an exponential spectrum and each ERT 4x4
+ * trigger fires with the given probability on a random supermodule. */
+class SyntheticEventGenerator: public SubsysReco
+{
+  public:
+    SyntheticEventGenerator(const std::string &name = "SyntheticEventGenerator");
+    virtual ~SyntheticEventGenerator();
+
+    int Init(PHCompositeNode *topNode);
+    int process_event(PHCompositeNode *topNode);
+
+    void set_seed(unsigned a_seed) { seed = a_seed; }
+    void set_runnumber(int a_runnumber) { runnumber = a_runnumber; }
+    void set_nclusters(double a_nclusters) { nclusters = a_nclusters; }
+    void set_ntracks(double a_ntracks) { ntracks = a_ntracks; }
+    void set_eslope(double a_eslope) { eslope = a_eslope; }
+    void set_ert_prob(double a_ert_prob) { ert_prob = a_ert_prob; }
+    void set_bbc_z_sigma(double a_bbc_z_sigma) { bbc_z_sigma = a_bbc_z_sigma; }
+
+    /* Trigger bits always set in scaled and live words */
+    void set_trig(unsigned a_trig) { trig = a_trig; }
+
+  protected:
+    void FillClusters();
+    void FillTracks();
+    void FillTrigger();
+
+    unsigned seed;
+    int runnumber;
+    double nclusters;
+    double ntracks;
+    double eslope;
+    double ert_prob;
+    double bbc_z_sigma;
+    unsigned trig;
+
+    TRandom3 *rnd;
+
+    RunHeader *runheader;
+    PHGlobal *data_global;
+    TrigLvl1 *data_triggerlvl1;
+    ErtOut *data_ert;
+    emcClusterContainer *data_emccontainer;
+    emcTowerContainer *data_emctwrcontainer;
+    PHCentralTrack *data_tracks;
+};
+
+#endif /* __SYNTHETICEVENTGENERATOR_H__ */
@@ -0,0 +1,176 @@
+/* Benchmark process_event of PhotonHistos or DirectPhotonPP on synthetic events.
+ *
+ * Usage: benchDirectPhotonPP [options]
+ *   -m module     PhotonHistos (default) or DirectPhotonPP
+ *   -d type       ERT (default) or MB data type
+ *   -n nevents    number of timed events (default 10000)
+ *   -w nwarmup    number of untimed events before (default 100)
+ *   -c nclusters  mean cluster multiplicity (default 20)
+ *   -t ntracks    mean track multiplicity (default 5)
+ *   -e ert_prob   probability for each ERT 4x4 trigger to fire (default 0.5)
+ *   -z sigma      BBC vertex width in cm (default 30)
+ *   -s seed       random seed (default 4357)
+ *   -r runnumber  run InitRun for this run (default 387027), 0 skips InitRun
+ *   -k snapshot   spin DB conditions snapshot for InitRun, see snapshotConditions,
+ *                 without it the run is queried from the spin DB
+ */
+
+#include "SyntheticEventGenerator.h"
+#include "PhotonHistos.h"
+#include "DirectPhotonPP.h"
+#include "EmcLocalRecalibratorSasha.h"
+#include "ConditionsCache.h"
+
+#include <Fun4AllServer.h>
+#include <PHCompositeNode.h>
+
+#include <TOAD.h>
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+namespace
+{
+  double Percentile(const vector<double> &sorted, double fraction)
+  {
+    if( sorted.empty() ) return 0.;
+    size_t i = (size_t)( fraction * (sorted.size() - 1) + 0.5 );
+    return sorted[i];
+  }
+
+  SubsysReco* CreateModule(const string &module, const string &datatype)
+  {
+    if( module == "PhotonHistos" )
+    {
+      PhotonHistos *ph = new PhotonHistos("PhotonHistos", "bench.root");
+      if( datatype == "MB" )
+        ph->SelectMB();
+      else
+        ph->SelectERT();
+      return ph;
+    }
+    else if( module == "DirectPhotonPP" )
+    {
+      TOAD toad_loader("DirectPhotonPP");
+      EmcLocalRecalibratorSasha *emcrecalib_sasha = new EmcLocalRecalibratorSasha();
+      emcrecalib_sasha->anaGetCorrCal( toad_loader.location("ecorr_run13pp500gev.txt").c_str() );
+      emcrecalib_sasha->anaGetCorrCal_run( toad_loader.location("ecorr_run_run13pp500gev.txt").c_str() );
+      emcrecalib_sasha->anaGetCorrTof( toad_loader.location("tcorr_run13pp500gev.txt").c_str() );
+
+      DirectPhotonPP *dp = new DirectPhotonPP("bench.root");
+      dp->SetDstDataType( datatype == "MB" ? "MinBias" : "ERT" );
+      dp->SetEmcLocalRecalibrator(emcrecalib_sasha);
+      return dp;
+    }
+
+    return nullptr;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  string module = "PhotonHistos";
+  string datatype = "ERT";
+  int nevents = 10000;
+  int nwarmup = 100;
+  int runnumber = 387027;
+  string snapshot;
+
+  SyntheticEventGenerator *gen = new SyntheticEventGenerator();
+
+  int opt;
+  while( (opt = getopt(argc, argv, "m:d:n:w:c:t:e:z:s:r:k:")) != -1 )
+    switch(opt)
+    {
+      case 'm': module = optarg; break;
+      case 'd': datatype = optarg; break;
+      case 'n': nevents = atoi(optarg); break;
+      case 'w': nwarmup = atoi(optarg); break;
+      case 'c': gen->set_nclusters( atof(optarg) ); break;
+      case 't': gen->set_ntracks( atof(optarg) ); break;
+      case 'e': gen->set_ert_prob( atof(optarg) ); break;
+      case 'z': gen->set_bbc_z_sigma( atof(optarg) ); break;
+      case 's': gen->set_seed( atoi(optarg) ); break;
+      case 'r': runnumber = atoi(optarg); break;
+      case 'k': snapshot = optarg; break;
+      default:
+        cerr << "Usage: " << argv[0] << " [-m module] [-d ERT|MB] [-n nevents] [-w nwarmup]"
+          " [-c nclusters] [-t ntracks] [-e ert_prob] [-z sigma] [-s seed] [-r runnumber] [-k snapshot]" << endl;
+        return 1;
+    }
+
+  /* MB sample is triggered on BBC only */
+  if( datatype == "MB" )
+    gen->set_ert_prob(0.);
+  gen->set_runnumber(runnumber);
+  if( !snapshot.empty() )
+    ConditionsCache::instance()->ReadSnapshot(snapshot);
+
+  SubsysReco *ana = CreateModule(module, datatype);
+  if(!ana)
+  {
+    cerr << "Unknown module " << module << endl;
+    return 1;
+  }
+
+  /* Use the node tree of the server but drive the modules by hand */
+  Fun4AllServer *se = Fun4AllServer::instance();
+  se->Verbosity(0);
+  PHCompositeNode *topNode = se->topNode();
+
+  gen->Init(topNode);
+  ana->Init(topNode);
+  if( runnumber > 0 )
+    ana->InitRun(topNode);
+
+  for(int ievent=0; ievent<nwarmup; ievent++)
+  {
+    gen->process_event(topNode);
+    ana->process_event(topNode);
+  }
+
+  vector<double> latency;
+  latency.reserve(nevents);
+
+  typedef chrono::steady_clock Clock;
+  Clock::duration total = Clock::duration::zero();
+  for(int ievent=0; ievent<nevents; ievent++)
+  {
+    gen->process_event(topNode);
+
+    Clock::time_point start = Clock::now();
+    ana->process_event(topNode);
+    Clock::duration elapsed = Clock::now() - start;
+
+    total += elapsed;
+    latency.push_back( chrono::duration<double, micro>(elapsed).count() );
+  }
+
+  ana->End(topNode);
+
+  sort(latency.begin(), latency.end());
+  double seconds = chrono::duration<double>(total).count();
+
+  cout << module << " (" << datatype << "): " << nevents << " events in "
+    << fixed << setprecision(3) << seconds << " s" << endl;
+  cout << "events/s: " << setprecision(1) << ( seconds > 0. ? nevents / seconds : 0. ) << endl;
+  cout << "latency [us]: mean " << ( nevents > 0 ? seconds * 1e6 / nevents : 0. )
+    << " p50 " << Percentile(latency, 0.50)
+    << " p90 " << Percentile(latency, 0.90)
+    << " p99 " << Percentile(latency, 0.99)
+    << " max " << ( latency.empty() ? 0. : latency.back() ) << endl;
+
+  delete ana;
+  delete gen;
+
+  return 0;
+}
@@ -0,0 +1,517 @@
+/* Merge histogram files, e.g. the per-run outputs of PhotonHistos or DirectPhotonPP.
+ *
+ * Usage: mergeHistos [options] output [input ...]
+ *   -j nproc      merge in nproc parallel processes (default 1)
+ *   -l list       also read input files from this list, one per line
+ *   -a            add the inputs to an existing output, inputs whose file name (without
+ *                 directory) is already in it are skipped
+ *
+ * Inputs are read one at a time, so there is no limit on the number of files.
+ * With -j the inputs are split into nproc parts, each merged by a forked process
+ * into a temporary file, and the parts are merged into the output at the end.
+ *
+ * Histograms are added bin array by bin array instead of TH1::Add. The keys of
+ * an input are matched to the merged objects in order, so inputs written by the
+ * same module need no name lookup, and empty histograms, e.g. the members of a
+ * HistogramFamily never booked in a run, are skipped. Profiles and other objects
+ * are merged with their Merge() method, objects without one are kept from the
+ * first input. Trees are not merged, use hadd for them.
+ * The names of the merged inputs are stored in the output as mergeHistos_inputs.
+ */
+
+#include <TROOT.h>
+#include <TClass.h>
+#include <TFile.h>
+#include <TKey.h>
+#include <TList.h>
+#include <TTree.h>
+#include <TH1.h>
+#include <TArrayD.h>
+#include <TArrayF.h>
+#include <TArrayI.h>
+#include <TObjString.h>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <unordered_map>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+using namespace std;
+
+namespace
+{
+  const char *INPUTS_KEY = "mergeHistos_inputs";
+
+  string BaseName(const string &filename)
+  {
+    size_t pos = filename.rfind('/');
+    return pos == string::npos ? filename : filename.substr(pos+1);
+  }
+
+  bool FileExists(const string &filename)
+  {
+    return access(filename.c_str(), F_OK) == 0;
+  }
+
+  /* Input names stored in a merged file, false if it is not a merged file */
+  bool ReadInputList(TFile *f, set<string> &inputs)
+  {
+    TObjString *list = dynamic_cast<TObjString*>( f->Get(INPUTS_KEY) );
+    if(!list)
+      return false;
+
+    istringstream sin( list->GetString().Data() );
+    string name;
+    while( getline(sin, name) )
+      if( !name.empty() )
+        inputs.insert(name);
+
+    delete list;
+    return true;
+  }
+
+  template<class T>
+    void AddArray(T *to, const T *from, int n)
+    {
+      for(int i=0; i<n; i++)
+        to[i] += from[i];
+    }
+
+  bool SameAxis(const TAxis *a1, const TAxis *a2)
+  {
+    return a1->GetNbins() == a2->GetNbins() &&
+      a1->GetXmin() == a2->GetXmin() &&
+      a1->GetXmax() == a2->GetXmax() &&
+      !a1->GetLabels() && !a2->GetLabels();
+  }
+
+  /* Histograms which can be added bin array by bin array */
+  bool CanAddBins(TH1 *to, TH1 *from)
+  {
+    return to->IsA() == from->IsA() &&
+      strncmp(to->ClassName(), "TProfile", 8) != 0 &&
+      to->GetNcells() == from->GetNcells() &&
+      SameAxis(to->GetXaxis(), from->GetXaxis()) &&
+      SameAxis(to->GetYaxis(), from->GetYaxis()) &&
+      SameAxis(to->GetZaxis(), from->GetZaxis());
+  }
+
+  /* Add contents, errors and statistics of from to to,
+   * false if the bin type is not handled */
+  bool AddBins(TH1 *to, TH1 *from)
+  {
+    TArrayD *d_to = dynamic_cast<TArrayD*>(to);
+    TArrayF *f_to = dynamic_cast<TArrayF*>(to);
+    TArrayI *i_to = dynamic_cast<TArrayI*>(to);
+    if( !d_to && !f_to && !i_to )
+      return false;
+
+    double stats_to[TH1::kNstat] = {};
+    double stats_from[TH1::kNstat] = {};
+    to->GetStats(stats_to);
+    from->GetStats(stats_from);
+    double entries = to->GetEntries() + from->GetEntries();
+
+    /* Errors before contents, Sumw2() initializes them from the contents */
+    const TArrayD *sumw2_from = from->GetSumw2();
+    if( sumw2_from->GetSize() > 0 && to->GetSumw2()->GetSize() == 0 )
+      to->Sumw2();
+    TArrayD *sumw2_to = to->GetSumw2();
+    int n = to->GetNcells();
+    if( sumw2_to->GetSize() > 0 )
+    {
+      if( sumw2_from->GetSize() > 0 )
+        AddArray(sumw2_to->GetArray(), sumw2_from->GetArray(), n);
+      else
+        for(int i=0; i<n; i++)
+          sumw2_to->GetArray()[i] += from->GetBinContent(i);
+    }
+
+    if(d_to)
+      AddArray(d_to->GetArray(), dynamic_cast<TArrayD*>(from)->GetArray(), n);
+    else if(f_to)
+      AddArray(f_to->GetArray(), dynamic_cast<TArrayF*>(from)->GetArray(), n);
+    else
+      AddArray(i_to->GetArray(), dynamic_cast<TArrayI*>(from)->GetArray(), n);
+
+    for(int i=0; i<TH1::kNstat; i++)
+      stats_to[i] += stats_from[i];
+    to->PutStats(stats_to);
+    to->SetEntries(entries);
+
+    return true;
+  }
+
+  bool IsEmpty(TH1 *h)
+  {
+    double stats[TH1::kNstat] = {};
+    h->GetStats(stats);
+    return h->GetEntries() == 0. && stats[0] == 0. && stats[1] == 0.;
+  }
+
+  /* Merged objects of all inputs in the order of the first input */
+  class Accumulator
+  {
+    public:
+      Accumulator(): nbulk(0), nmerge(0), nempty(0), pos(0) {}
+      ~Accumulator();
+
+      /* Add all objects of a file, its name is added to the input list */
+      bool Add(const string &filename);
+      bool Write(const string &filename) const;
+
+      set<string> inputs;
+      unsigned long nbulk;
+      unsigned long nmerge;
+      unsigned long nempty;
+
+    protected:
+      struct Entry
+      {
+        string path;
+        string name;
+        TObject *obj;
+      };
+
+      void AddDirectory(TDirectory *dir, const string &path);
+      void AddObject(size_t ientry, TObject *obj);
+
+      vector<Entry> entries;
+      unordered_map<string, size_t> index;
+      size_t pos;
+  };
+
+  Accumulator::~Accumulator()
+  {
+    for(unsigned i=0; i<entries.size(); i++)
+      delete entries[i].obj;
+  }
+
+  bool Accumulator::Add(const string &filename)
+  {
+    TFile *f = TFile::Open(filename.c_str());
+    if( !f || f->IsZombie() )
+    {
+      cerr << "mergeHistos: cannot open " << filename << endl;
+      delete f;
+      return false;
+    }
+
+    /* A merged file brings the list of its own inputs */
+    if( !ReadInputList(f, inputs) )
+      inputs.insert( BaseName(filename) );
+
+    pos = 0;
+    AddDirectory(f, "");
+
+    delete f;
+    return true;
+  }
+
+  void Accumulator::AddDirectory(TDirectory *dir, const string &path)
+  {
+    TIter next( dir->GetListOfKeys() );
+    TKey *key;
+    string prevname;
+    while( (key = (TKey*)next()) )
+    {
+      /* Only the highest cycle of a name */
+      string name = key->GetName();
+      if( name == prevname )
+        continue;
+      prevname = name;
+
+      if( path.empty() && name == INPUTS_KEY )
+        continue;
+
+      TClass *cl = TClass::GetClass( key->GetClassName() );
+      if( !cl )
+        continue;
+      if( cl->InheritsFrom(TDirectory::Class()) )
+      {
+        TDirectory *subdir = dir->GetDirectory(name.c_str());
+        if(subdir)
+          AddDirectory( subdir, path + name + "/" );
+        continue;
+      }
+      if( cl->InheritsFrom(TTree::Class()) )
+      {
+        cerr << "mergeHistos: tree " << path << name << " skipped" << endl;
+        continue;
+      }
+
+      /* Keys of files from the same module come in the same order */
+      size_t ientry;
+      if( pos < entries.size() && entries[pos].name == name && entries[pos].path == path )
+        ientry = pos;
+      else
+      {
+        string fullname = path + name;
+        unordered_map<string, size_t>::iterator it = index.find(fullname);
+        if( it != index.end() )
+          ientry = it->second;
+        else
+        {
+          Entry entry = {path, name, nullptr};
+          ientry = entries.size();
+          entries.push_back(entry);
+          index[fullname] = ientry;
+        }
+      }
+      pos = ientry + 1;
+
+      AddObject( ientry, key->ReadObj() );
+    }
+
+    return;
+  }
+
+  void Accumulator::AddObject(size_t ientry, TObject *obj)
+  {
+    Entry &entry = entries[ientry];
+    if( !entry.obj )
+    {
+      entry.obj = obj;
+      return;
+    }
+
+    TH1 *h_to = dynamic_cast<TH1*>(entry.obj);
+    TH1 *h_from = dynamic_cast<TH1*>(obj);
+    if( h_to && h_from && IsEmpty(h_from) )
+    {
+      nempty++;
+    }
+    else if( h_to && h_from && CanAddBins(h_to, h_from) && AddBins(h_to, h_from) )
+    {
+      nbulk++;
+    }
+    else if( ROOT::MergeFunc_t merge = entry.obj->IsA()->GetMerge() )
+    {
+      TList list;
+      list.Add(obj);
+      merge(entry.obj, &list, nullptr);
+      nmerge++;
+    }
+
+    delete obj;
+    return;
+  }
+
+  bool Accumulator::Write(const string &filename) const
+  {
+    /* Written aside and renamed, the output may be one of the inputs */
+    string tmpname = filename + ".tmp";
+    TFile *f = new TFile(tmpname.c_str(), "RECREATE");
+    if( !f->IsOpen() )
+    {
+      cerr << "mergeHistos: cannot create " << tmpname << endl;
+      delete f;
+      return false;
+    }
+
+    map<string, TDirectory*> dirs;
+    dirs[""] = f;
+    for(unsigned i=0; i<entries.size(); i++)
+    {
+      const Entry &entry = entries[i];
+      if( !entry.obj )
+        continue;
+
+      /* Create each level of the directory path once */
+      if( dirs.find(entry.path) == dirs.end() )
+      {
+        size_t start = 0, end;
+        while( (end = entry.path.find('/', start)) != string::npos )
+        {
+          string parent = entry.path.substr(0, start);
+          string sub = entry.path.substr(0, end+1);
+          if( dirs.find(sub) == dirs.end() )
+            dirs[sub] = dirs[parent]->mkdir( entry.path.substr(start, end-start).c_str() );
+          start = end + 1;
+        }
+      }
+
+      dirs[entry.path]->cd();
+      entry.obj->Write( entry.name.c_str() );
+    }
+
+    string list;
+    for(set<string>::const_iterator it = inputs.begin(); it != inputs.end(); ++it)
+      list += *it + "\n";
+    f->cd();
+    TObjString inputlist( list.c_str() );
+    inputlist.Write(INPUTS_KEY);
+
+    f->Close();
+    delete f;
+
+    if( rename(tmpname.c_str(), filename.c_str()) != 0 )
+    {
+      cerr << "mergeHistos: cannot rename " << tmpname << " to " << filename << endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  /* Merge inputs into output, start from output if append */
+  bool Merge(const vector<string> &inputs, const string &output, bool append)
+  {
+    Accumulator acc;
+    if( append && !acc.Add(output) )
+      return false;
+
+    for(unsigned i=0; i<inputs.size(); i++)
+      if( !acc.Add(inputs[i]) )
+        return false;
+
+    cout << "mergeHistos: " << inputs.size() << " files into " << output << ", "
+      << acc.nbulk << " histograms added, " << acc.nempty << " empty, "
+      << acc.nmerge << " other objects merged" << endl;
+
+    return acc.Write(output);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  int nproc = 1;
+  bool append = false;
+  vector<string> inputs;
+
+  int opt;
+  while( (opt = getopt(argc, argv, "j:l:a")) != -1 )
+    switch(opt)
+    {
+      case 'j': nproc = atoi(optarg); break;
+      case 'a': append = true; break;
+      case 'l':
+        {
+          ifstream fin(optarg);
+          if(!fin)
+          {
+            cerr << "Unable to open input list " << optarg << endl;
+            return 1;
+          }
+          string name;
+          while( fin >> name )
+            inputs.push_back(name);
+        }
+        break;
+      default:
+        cerr << "Usage: " << argv[0] << " [-j nproc] [-l list] [-a] output [input ...]" << endl;
+        return 1;
+    }
+
+  if( optind >= argc )
+  {
+    cerr << "Usage: " << argv[0] << " [-j nproc] [-l list] [-a] output [input ...]" << endl;
+    return 1;
+  }
+
+  string output = argv[optind];
+  for(int i=optind+1; i<argc; i++)
+    inputs.push_back(argv[i]);
+
+  /* Histograms belong to the accumulator, not to the file they are read from */
+  TH1::AddDirectory(kFALSE);
+  time_t start = time(nullptr);
+
+  /* Skip inputs given twice, and with -a inputs already merged, which are only
+   * known by their file name */
+  set<string> merged;
+  append = append && FileExists(output);
+  if(append)
+  {
+    TFile *f = TFile::Open(output.c_str());
+    if( !f || f->IsZombie() )
+    {
+      cerr << "mergeHistos: cannot open " << output << endl;
+      return 1;
+    }
+    ReadInputList(f, merged);
+    delete f;
+  }
+
+  vector<string> todo;
+  set<string> given;
+  for(unsigned i=0; i<inputs.size(); i++)
+    if( !given.insert(inputs[i]).second )
+      cout << "mergeHistos: " << inputs[i] << " given twice, skipped" << endl;
+    else if( append && !merged.insert( BaseName(inputs[i]) ).second )
+      cout << "mergeHistos: " << inputs[i] << " already merged, skipped" << endl;
+    else
+      todo.push_back(inputs[i]);
+
+  if( todo.empty() )
+  {
+    cout << "mergeHistos: nothing to merge" << endl;
+    return 0;
+  }
+
+  /* First level of the tree in forked processes, one part each */
+  vector<string> parts;
+  if( nproc > 1 && todo.size() >= 2*(unsigned)nproc )
+  {
+    vector<pid_t> pids;
+    cout.flush();
+    for(int iproc=0; iproc<nproc; iproc++)
+    {
+      vector<string> part( todo.begin() + todo.size()*iproc/nproc,
+          todo.begin() + todo.size()*(iproc+1)/nproc );
+      ostringstream partname;
+      partname << output << ".part" << iproc;
+      parts.push_back( partname.str() );
+
+      pid_t pid = fork();
+      if( pid == 0 )
+      {
+        bool ok = Merge(part, parts.back(), false);
+        cout.flush();
+        _exit(ok ? 0 : 1);
+      }
+      if( pid < 0 )
+      {
+        cerr << "mergeHistos: fork failed" << endl;
+        return 1;
+      }
+      pids.push_back(pid);
+    }
+
+    bool ok = true;
+    for(unsigned i=0; i<pids.size(); i++)
+    {
+      int status;
+      waitpid(pids[i], &status, 0);
+      ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    if(!ok)
+    {
+      cerr << "mergeHistos: merging a part failed" << endl;
+      for(unsigned i=0; i<parts.size(); i++)
+        remove( parts[i].c_str() );
+      return 1;
+    }
+
+    todo = parts;
+  }
+
+  bool ok = Merge(todo, output, append);
+  for(unsigned i=0; i<parts.size(); i++)
+    remove( parts[i].c_str() );
+
+  cout << "mergeHistos: done in " << time(nullptr) - start << " s" << endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+/* Write the spin DB conditions of a list of runs to a local snapshot for ConditionsCache.
+ *
+ * Usage: snapshotConditions [options] runlist output
+ *   -i input      start from this snapshot, only runs not in it are queried
+ *
+ * The run list has one run number per line. The query of each run overlaps
+ * with storing the previous one. Taxi jobs then read the snapshot with
+ *   ConditionsCache::instance()->ReadSnapshot("output");
+ * and do not need spin DB access for these runs.
+ */
+
+#include "ConditionsCache.h"
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+  string input;
+
+  int opt;
+  while( (opt = getopt(argc, argv, "i:")) != -1 )
+    switch(opt)
+    {
+      case 'i': input = optarg; break;
+      default:
+        cerr << "Usage: " << argv[0] << " [-i input] runlist output" << endl;
+        return 1;
+    }
+
+  if( optind != argc - 2 )
+  {
+    cerr << "Usage: " << argv[0] << " [-i input] runlist output" << endl;
+    return 1;
+  }
+
+  ConditionsCache *cache = ConditionsCache::instance();
+  if( !input.empty() )
+    cache->ReadSnapshot(input);
+
+  ifstream fin(argv[optind]);
+  if(!fin)
+  {
+    cerr << "Unable to open run list " << argv[optind] << endl;
+    return 1;
+  }
+
+  vector<int> runs;
+  int run;
+  while( fin >> run )
+    runs.push_back(run);
+
+  cache->SetRunList(runs);
+
+  int nbad = 0;
+  for(unsigned i=0; i<runs.size(); i++)
+  {
+    const RunConditions &cond = cache->Get(runs[i]);
+    if( !cond.spin_ok )
+    {
+      cerr << "Run " << runs[i] << ": no spin DB entry at QA level " << cond.qa_level << endl;
+      nbad++;
+    }
+  }
+
+  cache->WriteSnapshot(argv[optind+1]);
+  cout << runs.size() << " runs written to " << argv[optind+1]
+    << ", " << nbad << " without spin DB entry" << endl;
+
+  return 0;
+}
@@ -1,10 +1,15 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <cmath>
 #include <map>
 #include <cstring>
 #include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
 #include <sys/time.h>
+#include <unistd.h>
 #include <TStyle.h>
 #include <Pythia8/Pythia.h>
 #include <TFile.h>
@@ -21,82 +26,217 @@
 
 using namespace Pythia8;
 
+// Histogram with one set of bins filled for many weights at once
+// (e.g. scale/pdf variation). Contents of all weights are stored
+// contiguously per bin, so each fill needs only one bin search.
+// No ROOT object is created before Export(), so it can be filled in worker threads.
+//----------------------------------------------------------------------
+class MultiWeightHist {
+  public:
+    MultiWeightHist(const TH1D *h_template, const string &hname, const vector<string> &weight_names);
+
+    void Fill(double val, const vector<double> &weights);
+    void Add(const MultiWeightHist &other);
+    unsigned long int GetNweights() const { return names.size(); }
+
+    // export contents of one weight to a histogram named <name>_<weight name>
+    TH1D Export(unsigned long int iw) const;
+
+  private:
+    const TH1D *htemplate;
+    string name;
+    vector<string> names;
+    vector<double> edges;
+    double entries;
+    vector<double> sumw;  // [bin][weight]
+    vector<double> sumw2; // [bin][weight]
+    vector<double> stats; // [weight][sumw, sumw2, sumwx, sumwx2] for in-range fills
+};
+
+// Results of showering one LHE file
+//----------------------------------------------------------------------
+struct LHEFResult {
+  bool init;                      // whether histograms are booked
+  int nEvents;
+  vector<string> vec_weightsID;   // vector storing descriptive id of weights
+  vector<MultiWeightHist> vec_sim[2][2]; // vector for different rap. bins, each for different weights (e.g. for scale/pdf variation)
+
+  LHEFResult(): init(false), nEvents(0) {}
+};
+
+// Files of the job, handed out to the worker threads one by one
+//----------------------------------------------------------------------
+class LHEFQueue {
+  public:
+    LHEFQueue(const vector<string> &files): fileNames(files), next(0) {}
+
+    // get index of next file to process, false if there is none left
+    bool Pop(unsigned long int &iFile){
+      lock_guard<mutex> lock(mtx);
+      if(next >= fileNames.size()) return false;
+      iFile = next++;
+      return true;
+    }
+
+    const string& GetFile(unsigned long int iFile) const { return fileNames.at(iFile); }
+
+  private:
+    vector<string> fileNames;
+    unsigned long int next;
+    mutex mtx;
+};
+
+// fill histograms with simulation results
+//----------------------------------------------------------------------
+const int nPtBins = 30;
+const double etaAbsMin[4] = {0.0, 0.25, 0.35, 0.5};
+const double etaAbsMax[4] = {0.25, 0.35, 0.5, 1.0};
+const double ptBins[nPtBins+1] = { 0.0,
+  0.5, 1.0, 1.5, 2.0, 2.5, 3.0, 3.5, 4.0, 4.5, 5.0,
+  5.5, 6.0, 6.5, 7.0, 7.5, 8.0, 8.5, 9.0, 9.5, 10.0,
+  12.0, 14.0, 16.0, 18.0, 20.0, 22.0, 24.0, 26.0, 28.0, 30.0 };
+
+double CorrectPhiDelta(double a, double b);
+void ShowerLHEF(Pythia &pythia, const TH1D *h_photon, LHEFResult &result);
+void RunWorker(const char *cmndFileName, long unsigned int seed,
+    LHEFQueue *queue, const TH1D *h_photon, vector<LHEFResult> *results);
+
 int main(int, char **);
 int main(int argc, char **argv) {
 
-  double CorrectPhiDelta(double a, double b);
-  void Fill_For_Each_Weight(vector<TH1D> &vec_h, double val, vector<double> &vec_weights);
-
   int nFiles;
-  string fileName;
-  Pythia pythia;
-  _CPPHOOKS *powhegHooks = 0; // POWHEG UserHooks
-  bool loadhooks;
+  int nThreads = 1;
+  long unsigned int seed = 0;
 
   //---read commandline args----------------------------------------
-  if (argc < 4) {
+  int opt;
+  bool badopt = false;
+  while ((opt = getopt(argc, argv, "j:s:")) != -1)
+    switch (opt) {
+      case 'j': nThreads = atoi(optarg); break;
+      case 's': seed = strtoul(optarg, 0, 10); break;
+      default: badopt = true;
+    }
+  if (badopt || argc - optind < 3 || nThreads < 1) {
     cout << endl << "Usage: " << argv[0]
-      << " inputfile.cmnd outputfile.root eventfile1.lhe eventfile2.lhe ..." << endl;
+      << " [-j nthreads] [-s seed] inputfile.cmnd outputfile.root eventfile1.lhe eventfile2.lhe ..." << endl;
     exit(EXIT_FAILURE);
-  } 
-  const char *cmndFileName = argv[1]; // cmnd file
-  const char *rootFileName = argv[2]; // output file
-  nFiles = argc - 3; // number of event files to process
-  pythia.readFile(cmndFileName);
-
-  // first try getting seed from /dev/random
-  long unsigned int seed = 0;
-  ifstream devrandom;
-  devrandom.open("/dev/random",ios::binary);
-  devrandom.read((char*)&seed,sizeof(seed));
-
-  // check that devrandom worked
-  if (!devrandom.fail()) {
-    cout << "Got seed from /dev/random" << endl;
-    seed = seed%900000000 + 1;
   }
-  else {
-    // /dev/random failed, get the random seed from the time of day, to the microsecond
-    cout << "Getting seed from gettimeofday()" << endl;
-    timeval xtime;
-    int status = gettimeofday(&xtime,NULL);
-    if (status == 0) {
-      seed = ((xtime.tv_sec << 12) + (xtime.tv_usec&0xfff))%900000000 + 1;
+  const char *cmndFileName = argv[optind]; // cmnd file
+  const char *rootFileName = argv[optind+1]; // output file
+  nFiles = argc - optind - 2; // number of event files to process
+
+  if (seed == 0) {
+    // first try getting seed from /dev/random
+    ifstream devrandom;
+    devrandom.open("/dev/random",ios::binary);
+    devrandom.read((char*)&seed,sizeof(seed));
+
+    // check that devrandom worked
+    if (!devrandom.fail()) {
+      cout << "Got seed from /dev/random" << endl;
+      seed = seed%900000000 + 1;
     }
     else {
-      cout << "Something wrong with gettimeofday()" << endl;
-      seed = 0;
+      // /dev/random failed, get the random seed from the time of day, to the microsecond
+      cout << "Getting seed from gettimeofday()" << endl;
+      timeval xtime;
+      int status = gettimeofday(&xtime,NULL);
+      if (status == 0) {
+        seed = ((xtime.tv_sec << 12) + (xtime.tv_usec&0xfff))%900000000 + 1;
+      }
+      else {
+        cout << "Something wrong with gettimeofday()" << endl;
+        seed = 1;
+      }
     }
+    devrandom.close();
   }
-  devrandom.close();
-
-  pythia.readString("Random:setSeed = on");
-  pythia.readString(Form("Random:seed = %lu",seed));
+  cout << "Random seed " << seed << ", the i-th event file is showered with seed " << seed << "+i" << endl;
 
   TH1::SetDefaultSumw2(kTRUE);
   gStyle->SetOptStat(0);
 
-  // fill histograms with simulation results
-  const int nPtBins = 30;
-  const double etaAbsMin[4] = {0.0, 0.25, 0.35, 0.5};
-  const double etaAbsMax[4] = {0.25, 0.35, 0.5, 1.0};
-  const double ptBins[nPtBins+1] = { 0.0,
-    0.5, 1.0, 1.5, 2.0, 2.5, 3.0, 3.5, 4.0, 4.5, 5.0,
-    5.5, 6.0, 6.5, 7.0, 7.5, 8.0, 8.5, 9.0, 9.5, 10.0,
-    12.0, 14.0, 16.0, 18.0, 20.0, 22.0, 24.0, 26.0, 28.0, 30.0 };
-
   TH1D *h_events = new TH1D("h_events", "Events count", 1, 0.5, 1.5);
   TH1D *h_photon = new TH1D("h_photon", "Direct photon cross section;p_{T} [GeV];#frac{d#sigma}{dp_{T}} [pb/GeV]", nPtBins, ptBins);
-  vector< vector<TH1D> > vec_sim[2][2]; // two vector dimensions for different rap. bins & for different weights (e.g. for scale/pdf variation)
 
+  // loop over lhef files showering each event
+  // each worker thread has its own pythia instance and takes the next file from the queue
+  //----------------------------------------------------------------------
+  LHEFQueue queue( vector<string>(argv + optind + 2, argv + argc) );
+  vector<LHEFResult> results(nFiles);
 
-  // prepare bookkeeping of weights
+  if (nThreads > nFiles) nThreads = nFiles;
+  vector<thread> workers;
+  for (int iThread = 0; iThread < nThreads; iThread++)
+    workers.push_back( thread(RunWorker, cmndFileName, seed, &queue, h_photon, &results) );
+  for (int iThread = 0; iThread < nThreads; iThread++)
+    workers[iThread].join();
+
+  // merge results of all files in file order, independent of the number of threads
   //----------------------------------------------------------------------
-  const string sudaWeightID = "sudakovwgt";
-  bool isSudaWeight = false; // was photon radiation enhanced?
-  double sudaWeight = 1.;    // reweighting factor associated with radiation enhancement
-  vector<double> vec_weights;   // shall later contain: sudaWeight * primary event weight (using vector to store multiple weights, e.g for scale/pdf variation)
-  vector<string> vec_weightsID;// vector storing descriptive id of weights
+  int nEvents = 0;
+  LHEFResult *merged = 0;
+  for (int iFile = 0; iFile < nFiles; iFile++) {
+    LHEFResult &result = results[iFile];
+    nEvents += result.nEvents;
+    if (!result.init) continue;
+
+    if (!merged) {
+      merged = &result;
+      continue;
+    }
+    if (result.vec_weightsID.size() != merged->vec_weightsID.size()) {
+      cout << "Different number of weights in " << queue.GetFile(iFile) << endl;
+      exit(EXIT_FAILURE);
+    }
+    for(int iH=0; iH<2; iH++)
+      for(int iso=0; iso<2; iso++)
+        for(unsigned long int i = 0; i < result.vec_sim[iH][iso].size(); i++)
+          merged->vec_sim[iH][iso].at(i).Add(result.vec_sim[iH][iso].at(i));
+  }
+
+  // write histograms to file ----------------------------------------
+  TFile outFile(rootFileName, "RECREATE");
+
+  // store nEvents
+  h_events->SetBinContent(1, (double)nEvents);
+  h_events->Write();
+
+  // combine simulated spectra, then write
+  if (merged) {
+    vector<MultiWeightHist> (&vec_sim)[2][2] = merged->vec_sim;
+    for(unsigned long int i = 0; i < vec_sim[0][0].size(); i++){
+
+      for(int iH=0; iH<2; iH++)
+        vec_sim[iH][0].at(i).Add(vec_sim[iH][1].at(i));
+      for(int iso=0; iso<2; iso++)
+        vec_sim[0][iso].at(i).Add(vec_sim[1][iso].at(i));
+
+      for(unsigned long int j = 0; j < vec_sim[0][0].at(i).GetNweights(); j++)
+        for(int iH=0; iH<2; iH++)
+          for(int iso=0; iso<2; iso++)
+            vec_sim[iH][iso].at(i).Export(j).Write();
+    }
+  }
+
+  outFile.Close();
+
+  return 0;
+
+}
+
+// Worker thread: shower files from the queue with its own pythia instance
+//----------------------------------------------------------------------
+void RunWorker(const char *cmndFileName, long unsigned int seed,
+    LHEFQueue *queue, const TH1D *h_photon, vector<LHEFResult> *results){
+
+  Pythia pythia;
+  _CPPHOOKS *powhegHooks = 0; // POWHEG UserHooks
+  bool loadhooks;
+
+  pythia.readFile(cmndFileName);
+  pythia.readString("Random:setSeed = on");
 
   // pythia settings required for usage with powheg
   //----------------------------------------------------------------------
@@ -121,13 +261,48 @@ int main(int argc, char **argv) {
     pythia.setUserHooksPtr((UserHooks *) powhegHooks);
   }
 
+  bool first = true;
+  unsigned long int iFile;
+  while (queue->Pop(iFile)) {
 
-  // variables to keep track of
+    const string &fileName = queue->GetFile(iFile);
+    cout << "Showering events in " << fileName << endl;
+
+    // tell Pythia to use several lhe files while initializing once
+    if (!first) pythia.readString("Beams:newLHEFsameInit = on");
+    first = false;
+    pythia.readString("Beams:LHEF = " + fileName);
+    pythia.init();
+
+    // same random sequence for a file whichever thread showers it
+    pythia.rndm.init( (seed - 1 + iFile) % 900000000 + 1 );
+
+    ShowerLHEF(pythia, h_photon, results->at(iFile));
+  }
+
+  // statistics on event generation
+  if (!first) pythia.stat();
+
+  if (powhegHooks) delete powhegHooks;
+  return;
+}
+
+// Shower all events of the current LHE file and fill histograms
+//----------------------------------------------------------------------
+void ShowerLHEF(Pythia &pythia, const TH1D *h_photon, LHEFResult &result){
+
+  // prepare bookkeeping of weights
   //----------------------------------------------------------------------
-  bool init = false;    // whether initialized
+  const string sudaWeightID = "sudakovwgt";
+  bool isSudaWeight = false; // was photon radiation enhanced?
+  double sudaWeight = 1.;    // reweighting factor associated with radiation enhancement
+  vector<double> vec_weights;   // shall later contain: sudaWeight * primary event weight (using vector to store multiple weights, e.g for scale/pdf variation)
+  vector<string> &vec_weightsID = result.vec_weightsID;
+  vector<MultiWeightHist> (&vec_sim)[2][2] = result.vec_sim;
 
-  int nEvents = 0,
-      iPhoton = -1;     // index of photon in pythia event
+  // variables to keep track of
+  //----------------------------------------------------------------------
+  int iPhoton = -1;     // index of photon in pythia event
 
   double ptMax = 0., // pT of hardest photon
          ptTemp = 0.;
@@ -136,186 +311,144 @@ int main(int argc, char **argv) {
   double isoCone_mom;
   double isoCone_dR;
 
-
-  // loop over lhef files showering each event
+  // skip pythia errors and break, when showering has reached the end of the LHE file
   //----------------------------------------------------------------------
-  for (int iFile = 0; iFile < nFiles; iFile++) {
+  while (true) {
+    if (!pythia.next()) {
+      if (pythia.info.atEndOfFile()) break;
+      continue;
+    }
 
-    fileName = argv[3 + iFile];
-    cout << "Showering events in " << fileName << endl;
+    result.nEvents++;
 
-    // tell Pythia to use several lhe files while initializing once
-    if (iFile == 1) pythia.readString("Beams:newLHEFsameInit = on");
-    pythia.readString("Beams:LHEF = " + fileName);
-    pythia.init();
-
-    // skip pythia errors and break, when showering has reached the end of the LHE file
+    // at very first event read in weight IDs and book histograms for each weight
     //----------------------------------------------------------------------
-    while (true) {
-      if (!pythia.next()) {
-        if (pythia.info.atEndOfFile()) break;
-        continue;
-      }
-
-      nEvents++;
+    if (!result.init) {
 
-      // at very first event read in weight IDs and book histograms for each weight
-      //----------------------------------------------------------------------
-      if (!init) {
+      result.init = true;
 
-        init = true;
-
-        // check if the sudakov weight from enhanced radiation is present
-        for (map<string,double>::iterator it = pythia.info.weights_detailed->begin();
-            it != pythia.info.weights_detailed->end(); ++it) {
-          if (it->first == sudaWeightID.c_str()) {
-            isSudaWeight = true;
-            printf("Sudakov reweighting of hard process is taken into account.\n");
-            continue;
-          }
+      // check if the sudakov weight from enhanced radiation is present
+      for (map<string,double>::iterator it = pythia.info.weights_detailed->begin();
+          it != pythia.info.weights_detailed->end(); ++it) {
+        if (it->first == sudaWeightID.c_str()) {
+          isSudaWeight = true;
+          printf("Sudakov reweighting of hard process is taken into account.\n");
+          continue;
         }
+      }
 
-        // if more weights at the same time are used,
-        // e.g. for scale or pdf variation, you can  access them like this
-        int weight_id = 0;
-        for (vector<double>::iterator it = pythia.info.weights_compressed->begin();
-            it != pythia.info.weights_compressed->end(); ++it) {
-          vec_weightsID.push_back(Form("id%d",weight_id++));
-        }
-
-        printf("Number of weights = %lu\n", vec_weightsID.size());
-        for(long unsigned int i = 0; i < vec_weightsID.size(); i++)
-          printf("weight description at position %lu: %s\n", i, vec_weightsID.at(i).c_str());
-
-        // book histograms for each weight
-        for(int iH=0; iH<2; iH++)
-          for(int iso=0; iso<2; iso++)
-            for(int i = 0; i <= 3; i++){ // consider each rapidity bin
-              vector <TH1D> vec_histo_temp;
-              for(long unsigned int j = 0; j < vec_weightsID.size(); j++){
-                vec_histo_temp.push_back( *(TH1D*)h_photon->Clone(Form("hard%d_iso%d_rap%d_%s",iH,iso,i,vec_weightsID.at(j).c_str())) );
-              }
-              vec_sim[iH][iso].push_back(vec_histo_temp);
-            }	 
-      } // back to the general event loop...
-
-
-      // if Sudakov reweighting is activated, get corresponding weight for this event
-      if (isSudaWeight) sudaWeight = pythia.info.getWeightsDetailedValue(sudaWeightID.c_str());
-
-      // reload vector with regular weights * sudaWeight for this event 
-      if(vec_weights.size() != 0) vec_weights.clear();
+      // if more weights at the same time are used,
+      // e.g. for scale or pdf variation, you can  access them like this
+      int weight_id = 0;
       for (vector<double>::iterator it = pythia.info.weights_compressed->begin();
           it != pythia.info.weights_compressed->end(); ++it) {
-        vec_weights.push_back((*it) * sudaWeight);
+        ostringstream id;
+        id << "id" << weight_id++;
+        vec_weightsID.push_back(id.str());
       }
 
-      // The actual event analysis starts here.
-      ptMax  = 0.;
-      ptTemp = 0.;
-      iPhoton = -1;
-
-      // search for hardest photon in this event
-      //----------------------------------------------------------------------
-      for (int i = 5; i < pythia.event.size(); i++) {
-        if (pythia.event[i].id() == 22 && pythia.event[i].isFinal() && // final photon
-            pythia.event[i].status() < 90 &&                      // no decay photons allowed, only direct photons
-            TMath::Abs(pythia.event[i].eta()) < etaAbsMax[3] &&   // in maximal acceptance
-            pythia.event[i].pT() > ptBins[4]){                    // in the pt reach of interest
-
-          // find ptMax
-          ptTemp = pythia.event[i].pT();
-          if (ptTemp > ptMax) {
-            ptMax = ptTemp;
-            iPhoton = i; // remember index of hardest photon
-          }
-        }
-      }
-
-      // skip to next event, if no photon was found
-      if(iPhoton < 0) continue;
+      printf("Number of weights = %lu\n", vec_weightsID.size());
+      for(long unsigned int i = 0; i < vec_weightsID.size(); i++)
+        printf("weight description at position %lu: %s\n", i, vec_weightsID.at(i).c_str());
 
-      // use following line to ignore events with extreme weights that can cause ugly fluctuations
-      // but make sure the cross section does not decrease significantly
-      if(ptMax > pythia.info.getScalesAttribute("uborns")*2.5){
-        nEvents--;
-        continue;
-      }
-
-      // loop over all direct photons in this event
-      //----------------------------------------------------------------------
-      for (int iDir = 5; iDir < pythia.event.size(); iDir++)
-        if (pythia.event[iDir].id() == 22 && pythia.event[iDir].isFinal() && // final photon
-            pythia.event[iDir].status() < 90 &&                      // no decay photons allowed, only direct photons
-            TMath::Abs(pythia.event[iDir].eta()) < etaAbsMax[3] &&   // in maximal acceptance
-            pythia.event[iDir].pT() > ptBins[4]){                    // in the pt reach of interest
-
-          // check whether it is the hardest photon and get its pt and eta
-          int iH = (iDir == iPhoton ? 1 : 0);
-          double ptDir = pythia.event[iDir].pT();
-          double eDir = pythia.event[iDir].e();
-          double etaAbsDir = TMath::Abs(pythia.event[iDir].eta());
-
-          // isolation cut: sum energy around photon and check whether threshold is reached
-          //----------------------------------------------------------------------
-          isoCone_mom = 0.; // reset sum of energy in cone
-          for (int i = 5; i < pythia.event.size(); i++) {
-            if ( !pythia.event[i].isFinal() ) continue;
-            if ( !pythia.event[i].isVisible() ) continue;
-            if ( TMath::Abs(pythia.event[i].eta()) > etaAbsMax[3]+isoConeRadius ) continue;
-            if ( i == iDir ) continue;
-
-            // distance between photon and particle at index i
-            isoCone_dR = sqrt( pow2(CorrectPhiDelta(pythia.event[i].phi(), pythia.event[iDir].phi()))
-                + pow2(pythia.event[i].eta() - pythia.event[iDir].eta()) );
-
-            // sum energy in isolation cone
-            if(isoCone_dR < isoConeRadius) isoCone_mom += pythia.event[i].pAbs();
+      // book histograms for each weight
+      for(int iH=0; iH<2; iH++)
+        for(int iso=0; iso<2; iso++)
+          for(int i = 0; i <= 3; i++){ // consider each rapidity bin
+            ostringstream hname;
+            hname << "hard" << iH << "_iso" << iso << "_rap" << i;
+            vec_sim[iH][iso].push_back( MultiWeightHist(h_photon, hname.str(), vec_weightsID) );
           }
+    } // back to the general event loop...
 
-          // check whether threshold is reached
-          int iso = (isoCone_mom < 0.1*eDir ? 1 : 0);
 
-          // Fill histograms
-          //----------------------------------------------------------------------
-          for( int i = 0; i <= 3; i++)
-            if( etaAbsMin[i] < etaAbsDir &&
-                etaAbsDir < etaAbsMax[i] )
-              Fill_For_Each_Weight(vec_sim[iH][iso].at(i), ptDir, vec_weights);
+    // if Sudakov reweighting is activated, get corresponding weight for this event
+    if (isSudaWeight) sudaWeight = pythia.info.getWeightsDetailedValue(sudaWeightID.c_str());
 
-        } // end of direct photon loop
-    } // end of while loop; break if next file
-  } // end of file loop
+    // reload vector with regular weights * sudaWeight for this event
+    if(vec_weights.size() != 0) vec_weights.clear();
+    for (vector<double>::iterator it = pythia.info.weights_compressed->begin();
+        it != pythia.info.weights_compressed->end(); ++it) {
+      vec_weights.push_back((*it) * sudaWeight);
+    }
 
-  // statistics on event generation
-  pythia.stat();
+    // The actual event analysis starts here.
+    ptMax  = 0.;
+    ptTemp = 0.;
+    iPhoton = -1;
 
-  // write histograms to file ----------------------------------------
-  TFile outFile(rootFileName, "RECREATE");
+    // search for hardest photon in this event
+    //----------------------------------------------------------------------
+    for (int i = 5; i < pythia.event.size(); i++) {
+      if (pythia.event[i].id() == 22 && pythia.event[i].isFinal() && // final photon
+          pythia.event[i].status() < 90 &&                      // no decay photons allowed, only direct photons
+          TMath::Abs(pythia.event[i].eta()) < etaAbsMax[3] &&   // in maximal acceptance
+          pythia.event[i].pT() > ptBins[4]){                    // in the pt reach of interest
+
+        // find ptMax
+        ptTemp = pythia.event[i].pT();
+        if (ptTemp > ptMax) {
+          ptMax = ptTemp;
+          iPhoton = i; // remember index of hardest photon
+        }
+      }
+    }
 
-  // store nEvents
-  h_events->SetBinContent(1, (double)nEvents);
-  h_events->Write();
+    // skip to next event, if no photon was found
+    if(iPhoton < 0) continue;
 
-  // combine simulated spectra, then write
-  for(int i = 0; i <= 3; i++)
-    for(unsigned long int j = 0; j < vec_weights.size(); j++){
+    // use following line to ignore events with extreme weights that can cause ugly fluctuations
+    // but make sure the cross section does not decrease significantly
+    if(ptMax > pythia.info.getScalesAttribute("uborns")*2.5){
+      result.nEvents--;
+      continue;
+    }
 
-      for(int iH=0; iH<2; iH++)
-        vec_sim[iH][0].at(i).at(j).Add(&vec_sim[iH][1].at(i).at(j));
-      for(int iso=0; iso<2; iso++)
-        vec_sim[0][iso].at(i).at(j).Add(&vec_sim[1][iso].at(i).at(j));
+    // loop over all direct photons in this event
+    //----------------------------------------------------------------------
+    for (int iDir = 5; iDir < pythia.event.size(); iDir++)
+      if (pythia.event[iDir].id() == 22 && pythia.event[iDir].isFinal() && // final photon
+          pythia.event[iDir].status() < 90 &&                      // no decay photons allowed, only direct photons
+          TMath::Abs(pythia.event[iDir].eta()) < etaAbsMax[3] &&   // in maximal acceptance
+          pythia.event[iDir].pT() > ptBins[4]){                    // in the pt reach of interest
+
+        // check whether it is the hardest photon and get its pt and eta
+        int iH = (iDir == iPhoton ? 1 : 0);
+        double ptDir = pythia.event[iDir].pT();
+        double eDir = pythia.event[iDir].e();
+        double etaAbsDir = TMath::Abs(pythia.event[iDir].eta());
+
+        // isolation cut: sum energy around photon and check whether threshold is reached
+        //----------------------------------------------------------------------
+        isoCone_mom = 0.; // reset sum of energy in cone
+        for (int i = 5; i < pythia.event.size(); i++) {
+          if ( !pythia.event[i].isFinal() ) continue;
+          if ( !pythia.event[i].isVisible() ) continue;
+          if ( TMath::Abs(pythia.event[i].eta()) > etaAbsMax[3]+isoConeRadius ) continue;
+          if ( i == iDir ) continue;
+
+          // distance between photon and particle at index i
+          isoCone_dR = sqrt( pow2(CorrectPhiDelta(pythia.event[i].phi(), pythia.event[iDir].phi()))
+              + pow2(pythia.event[i].eta() - pythia.event[iDir].eta()) );
+
+          // sum energy in isolation cone
+          if(isoCone_dR < isoConeRadius) isoCone_mom += pythia.event[i].pAbs();
+        }
 
-      for(int iH=0; iH<2; iH++)
-        for(int iso=0; iso<2; iso++)
-          vec_sim[iH][iso].at(i).at(j).Write();
-    }
+        // check whether threshold is reached
+        int iso = (isoCone_mom < 0.1*eDir ? 1 : 0);
 
-  outFile.Close();
+        // Fill histograms
+        //----------------------------------------------------------------------
+        for( int i = 0; i <= 3; i++)
+          if( etaAbsMin[i] < etaAbsDir &&
+              etaAbsDir < etaAbsMax[i] )
+            vec_sim[iH][iso].at(i).Fill(ptDir, vec_weights);
 
-  if (powhegHooks) delete powhegHooks;
-  return 0;
+      } // end of direct photon loop
+  } // end of while loop; break if next file
 
+  return;
 }
 
 // PYTHIA8's phi goes from -pi to pi; compute correct angle difference
@@ -328,12 +461,82 @@ double CorrectPhiDelta(double angle1, double angle2){
 }
 
 //----------------------------------------------------------------------
-void Fill_For_Each_Weight(vector<TH1D> &vec_h, double val, vector<double> &vec_weights){
+MultiWeightHist::MultiWeightHist(const TH1D *h_template, const string &hname, const vector<string> &weight_names):
+  htemplate(h_template),
+  name(hname),
+  names(weight_names),
+  entries(0.)
+{
+  const TAxis *axis = htemplate->GetXaxis();
+  int nbins = axis->GetNbins();
+  for(int ib = 1; ib <= nbins+1; ib++)
+    edges.push_back(axis->GetBinLowEdge(ib));
+
+  sumw.assign((nbins+2)*names.size(), 0.);
+  sumw2.assign((nbins+2)*names.size(), 0.);
+  stats.assign(4*names.size(), 0.);
+}
 
-  for(unsigned long int i = 0; i < vec_weights.size(); i++)
-    vec_h.at(i).Fill(val,vec_weights.at(i));
+//----------------------------------------------------------------------
+void MultiWeightHist::Fill(double val, const vector<double> &weights){
+
+  // same bin numbering as TAxis::FindBin, 0 is underflow and nbins+1 overflow
+  unsigned long int bin = upper_bound(edges.begin(), edges.end(), val) - edges.begin();
+  unsigned long int nw = min(weights.size(), names.size());
+
+  double *w = &sumw[bin*names.size()];
+  double *w2 = &sumw2[bin*names.size()];
+  for(unsigned long int i = 0; i < nw; i++){
+    w[i] += weights[i];
+    w2[i] += weights[i]*weights[i];
+  }
+
+  entries++;
+  if(bin == 0 || bin == edges.size()) return;
+
+  for(unsigned long int i = 0; i < nw; i++){
+    double *st = &stats[4*i];
+    st[0] += weights[i];
+    st[1] += weights[i]*weights[i];
+    st[2] += weights[i]*val;
+    st[3] += weights[i]*val*val;
+  }
 
   return;
 }
 
 //----------------------------------------------------------------------
+void MultiWeightHist::Add(const MultiWeightHist &other){
+
+  for(unsigned long int i = 0; i < sumw.size(); i++){
+    sumw[i] += other.sumw[i];
+    sumw2[i] += other.sumw2[i];
+  }
+  for(unsigned long int i = 0; i < stats.size(); i++)
+    stats[i] += other.stats[i];
+  entries += other.entries;
+
+  return;
+}
+
+//----------------------------------------------------------------------
+TH1D MultiWeightHist::Export(unsigned long int iw) const{
+
+  TH1D h(*htemplate);
+  h.Reset();
+  h.SetName(Form("%s_%s", name.c_str(), names.at(iw).c_str()));
+
+  for(unsigned long int bin = 0; bin <= edges.size(); bin++){
+    h.SetBinContent(bin, sumw[bin*names.size()+iw]);
+    h.SetBinError(bin, sqrt(sumw2[bin*names.size()+iw]));
+  }
+
+  double st[4];
+  copy(stats.begin()+4*iw, stats.begin()+4*iw+4, st);
+  h.PutStats(st);
+  h.SetEntries(entries);
+
+  return h;
+}
+
+//----------------------------------------------------------------------
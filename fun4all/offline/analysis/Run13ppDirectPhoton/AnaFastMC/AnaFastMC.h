@@ -2,6 +2,7 @@
 #define __ANAFASTMC_H__
 
 #include <SubsysReco.h>
+#include <AnaToolsDenseHist.h>
 
 #include <Rtypes.h>
 #include <TLorentzVector.h>
@@ -47,15 +48,11 @@ class AnaFastMC: public SubsysReco
   protected:
     static const int MAXPEAK = 2;
 
+    /* Tower energy arrays keep the PbSc rows and columns beyond the sector (phantom towers) */
     static const int NSEC = 8;
     static const int NY = 48;
     static const int NZ = 96;
 
-    static const int nY_sc = 36;
-    static const int nZ_sc = 72;
-    static const int nY_gl = 48;
-    static const int nZ_gl = 96;
-
     static const int n_twrs = 24768;
 
     static const int nh_eta_phi = 3*3;
@@ -97,7 +94,7 @@ class AnaFastMC: public SubsysReco
     bool sysgeom;
 
     /* Tower status for sim warnmap */
-    int tower_status_sim[NSEC][NY][NZ];
+    int tower_status_sim[n_twrs];
 
     int NPart;
     int NPeak;
@@ -131,6 +128,11 @@ class AnaFastMC: public SubsysReco
     THnSparse *hn_photon;
     THnSparse *hn_hadron;
     THnSparse *hn_geom;
+
+    /* Dense fill buffers for the tables small enough to allocate in full,
+     * flushed in End(). The tables with more axes stay sparse. */
+    anatools::DenseHist<4> hd_photon;
+    anatools::DenseHist<3> hd_geom;
 };
 
 #endif	/* __ANAFASTMC_H__ */
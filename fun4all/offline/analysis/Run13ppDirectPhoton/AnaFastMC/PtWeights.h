@@ -6,6 +6,18 @@ class TF1;
 class TFile;
 class TH2;
 
+#include <vector>
+
+/* Lookup table of log(weight) on a uniform grid in log(pT) */
+struct PtWeightTable
+{
+  double lnpt_min;
+  double lnpt_max;
+  double dlnpt;
+  double max_relerr;
+  std::vector<double> lnw;
+};
+
 class PtWeights
 {
   public:
@@ -15,13 +27,19 @@ class PtWeights
     void WeightXsec(Fun4AllHistoManager *hm);
     double EvalPi0(double pt);
     double EvalPhoton(double pt);
+    void EvalPi0(unsigned n, const double *pt, double *weight);
+    void EvalPhoton(unsigned n, const double *pt, double *weight);
     double Integral(double pt1, double pt2, const char *option);
 
   protected:
     void ReadWeights();
+    void BuildTable(TF1 *f, PtWeightTable &table);
+    double Interpolate(const PtWeightTable &table, TF1 *f, double pt);
 
     TF1 *cross_pi0;
     TF1 *cross_ph;
+    PtWeightTable table_pi0;
+    PtWeightTable table_ph;
     TFile *f_mb;
     TH2 *h2_mb;
 };
@@ -2,8 +2,9 @@
 #define __ANAPHPYTHIADIRECTPHOTON_H__
 
 #include "SubsysReco.h"
+#include <AnaToolsTreeColumns.h>
 
-#include <map>
+#include <vector>
 
 class PHCompositeNode;
 class PHPythiaHeader;
@@ -30,13 +31,13 @@ public:
 
 protected:
 
-  /** sum up electromagnetic energy within cone of fixed opening
-      angle rcone around particle with vector vref */
-  float SumEEmcal( TMCParticle* pref, float rcone );
+  /** sum up electromagnetic energy within cones of opening
+      angles rcone around particle with vector vref, all cones in one pass */
+  void SumEEmcal( TMCParticle* pref, const std::vector<float> &rcone, std::vector<float> &econe );
 
-  /** sum up charged traack momenta within cone of fixed opening
-      angle rcone around particle with vector vref */
-  float SumPTrack( TMCParticle* pref, float rcone );
+  /** sum up charged traack momenta within cones of opening
+      angles rcone around particle with vector vref, all cones in one pass */
+  void SumPTrack( TMCParticle* pref, const std::vector<float> &rcone, std::vector<float> &pcone );
 
   /** Reset global variables that store cluster information for filling output tree */
   void ResetBranchVariables();
@@ -53,13 +54,24 @@ protected:
   /** output tree with truth information */
   TTree* _tree_event_truth;
 
-  /** Map of Event properties that will be written to
+  /** Event properties that will be written to
    * output ROOT Tree */
-  std::map< std::string , float > _branchmap_event;
+  anatools::TreeColumns _columns_event;
+  int _col_eventcounter;
+  int _col_pythia_event;
+  int _col_pythia_processid;
 
-  /** Map of Particle (or cluster) properties that will be written to
+  /** Particle (or cluster) properties that will be written to
    * output ROOT Tree */
-  std::map< std::string , std::vector< float > > _branchmap_mcparticles;
+  anatools::TreeColumns _columns_mcparticles;
+  int _col_t_pid;
+  int _col_t_parentpid;
+  int _col_t_ispromptphoton;
+  int _col_t_ptot;
+  int _col_t_pt;
+  int _col_t_etot;
+  int _col_t_eta;
+  int _col_t_phi;
 
   unsigned int _ievent;
 
@@ -2,6 +2,7 @@
 #define __ANAPHPYTHIAHISTOS_H__
 
 #include <string>
+#include <vector>
 #include <SubsysReco.h>
 
 class PHCompositeNode;
@@ -26,9 +27,9 @@ class AnaPHPythiaHistos: public SubsysReco
     int End(PHCompositeNode *topNode);
 
   protected:
-    /* Sum up truth energy within cone of fixed opening
-     * angle rcone around particle with vector vref */
-    double SumETruth(const TMCParticle* pref, double rcone);
+    /* Sum up truth energy within cones of opening angles
+     * rcone around particle with vector vref, all cones in one pass */
+    void SumETruth(const TMCParticle* pref, const std::vector<double> &rcone, std::vector<double> &econe);
 
     /* Fill two-particle correlation histogram */
     void FillCorrelation(const TMCParticle *pref, int type);
@@ -0,0 +1,315 @@
+#!/usr/bin/python
+# Run the processes of a Condor submit file, or a list of commands, on the local node.
+#
+# Usage: ../LocalQueue.py [-j 16] [--memory 64G] [--retries 2] [--procs 0-99]
+#                         [--merge total.root --output 'histos/X$(Process).root']
+#                         (job file | -t task list)
+#
+# From a submit file (e.g. anaFastMC_Fast.job) Executable, Arguments,
+# Initialdir, request_memory and Queue are used, $(Process), $(Initialdir) and
+# $ENV(X) are substituted. The condor-root.csh and condor-bash.csh wrappers
+# are replaced by running the macro in root or the script in bash in Initialdir.
+# A task list has one shell command per line, $(Process) is the line index,
+# so shell loops like extract_pi0peak.sh become one task per run.
+#
+# Each worker starts with a contiguous block of processes and steals from the
+# end of the longest queue when its own is empty. A task only starts when its
+# request_memory fits in the memory not used by running tasks. Failed tasks
+# are retried, the processes still failing are written to <job>.failed and can
+# be rerun with --procs. With --merge the output of each finished process is
+# added to the merged file while the other processes are running.
+# Logs are in logs/<job>-<process>.log, each task gets its own scratch
+# directory as _CONDOR_SCRATCH_DIR.
+
+from __future__ import print_function
+
+import argparse
+import collections
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+try:
+    import queue
+except ImportError:
+    import Queue as queue
+
+Task = collections.namedtuple("Task", ["process", "cmd", "cwd", "memory"])
+
+def ParseMemory(value):
+    """Memory in MB, Condor takes MB if no unit is given"""
+    m = re.match(r"\s*([0-9.]+)\s*([KMGT]?)B?\s*$", value.upper())
+    if not m:
+        raise ValueError("Cannot parse memory %s" % value)
+    scale = {"K": 1. / 1024, "": 1., "M": 1., "G": 1024., "T": 1024. * 1024}
+    return int(float(m.group(1)) * scale[m.group(2)])
+
+def ParseProcs(value, nproc):
+    procs = []
+    for item in value.split(","):
+        if "-" in item:
+            first, last = item.split("-")
+            procs += range(int(first), int(last) + 1)
+        elif item:
+            procs.append(int(item))
+    return [p for p in procs if p < nproc]
+
+def Substitute(text, process, initialdir):
+    text = text.replace("$(Process)", str(process)).replace("$(Initialdir)", initialdir)
+    return re.sub(r"\$ENV\((\w+)\)", lambda m: os.environ.get(m.group(1), ""), text)
+
+def ReadJob(fname):
+    """Tasks of a Condor submit file"""
+    keys = {}
+    nproc = 1
+    for line in open(fname):
+        line = line.split("#")[0].strip()
+        m = re.match(r"(\w+)\s*=\s*(.*)$", line)
+        if m:
+            keys[m.group(1).lower()] = m.group(2).strip()
+        elif line.lower().startswith("queue"):
+            items = line.split()
+            nproc = int(items[1]) if len(items) > 1 else 1
+
+    initialdir = os.path.abspath(Substitute(keys.get("initialdir", "."), 0, ""))
+    memory = ParseMemory(keys.get("request_memory", "0"))
+    executable = keys["executable"]
+    tasks = []
+    for process in range(nproc):
+        args = Substitute(keys.get("arguments", ""), process, initialdir).split()
+        wrapper = os.path.basename(executable)
+        if wrapper == "condor-root.csh":
+            # Arguments: Initialdir macro Process
+            cmd = ["root", "-l", "-b", "-q", "%s(%s)" % (args[1], args[2])]
+        elif wrapper == "condor-bash.csh":
+            # Arguments: Initialdir script Process
+            cmd = ["bash", args[1]] + args[2:]
+        else:
+            cmd = [os.path.join(initialdir, executable)] + args
+        tasks.append(Task(process, cmd, initialdir, memory))
+    return tasks
+
+def ReadTaskList(fname, memory):
+    tasks = []
+    for line in open(fname):
+        line = line.strip()
+        if line and not line.startswith("#"):
+            process = len(tasks)
+            cmd = ["bash", "-c", Substitute(line, process, os.getcwd())]
+            tasks.append(Task(process, cmd, os.getcwd(), memory))
+    return tasks
+
+def TotalMemory():
+    """Physical memory in MB"""
+    for line in open("/proc/meminfo"):
+        if line.startswith("MemTotal:"):
+            return int(line.split()[1]) // 1024
+    return 0
+
+class Scheduler(object):
+    """Per worker queues with stealing and memory admission"""
+
+    def __init__(self, tasks, nworkers, memory, retries):
+        self.lock = threading.Condition()
+        self.queues = [collections.deque() for i in range(nworkers)]
+        for i, task in enumerate(tasks):
+            self.queues[i * nworkers // len(tasks)].append((task, 1))
+        self.memory = memory
+        self.used = 0
+        self.retries = retries
+        self.running = 0
+        self.stolen = 0
+
+    def Next(self, worker):
+        """Own queue from the front, else steal from the back of the longest queue"""
+        with self.lock:
+            while True:
+                if self.queues[worker]:
+                    item = self.queues[worker].popleft()
+                else:
+                    victim = max(self.queues, key=len)
+                    if not victim:
+                        if self.running == 0:
+                            return None
+                        # A running task may still be retried
+                        self.lock.wait()
+                        continue
+                    item = victim.pop()
+                    self.stolen += 1
+
+                # A task larger than the budget runs alone
+                need = min(item[0].memory, self.memory)
+                while self.used > 0 and self.used + need > self.memory:
+                    self.lock.wait()
+                self.used += need
+                self.running += 1
+                return item + (need,)
+
+    def Done(self, worker, item, ok):
+        """Returns True if the task is queued again"""
+        task, attempt, need = item
+        with self.lock:
+            self.used -= need
+            self.running -= 1
+            retry = not ok and attempt <= self.retries
+            if retry:
+                self.queues[worker].append((task, attempt + 1))
+            self.lock.notify_all()
+        return retry
+
+class Merger(object):
+    """Adds finished outputs to the merged file in batches"""
+
+    def __init__(self, output, batch):
+        self.output = output
+        self.batch = batch
+        self.nmerged = 0
+        try:
+            import ROOT
+            ROOT.gROOT.SetBatch(True)
+            self.merger = ROOT.TFileMerger(False, False)
+            self.merger.OutputFile(output, "RECREATE")
+            self.mode = ROOT.TFileMerger.kIncremental | ROOT.TFileMerger.kAll
+        except ImportError:
+            print("No PyROOT, merging with hadd")
+            self.merger = None
+
+    def Merge(self, files):
+        if not files:
+            return True
+        if self.merger:
+            for f in files:
+                self.merger.AddFile(f, False)
+            ok = self.merger.PartialMerge(self.mode)
+        else:
+            cmd = ["hadd", "-a" if self.nmerged else "-f", self.output] + files
+            ok = subprocess.call(cmd, stdout=open(os.devnull, "w")) == 0
+        if ok:
+            self.nmerged += len(files)
+        else:
+            print("Merging %s failed" % " ".join(files))
+        return ok
+
+def Work(worker, scheduler, name, logdir, done, report):
+    while True:
+        item = scheduler.Next(worker)
+        if item is None:
+            return
+        task, attempt, need = item
+        scratch = tempfile.mkdtemp(prefix="%s-%d-" % (name, task.process))
+        env = dict(os.environ, _CONDOR_SCRATCH_DIR=scratch)
+        log = open(os.path.join(logdir, "%s-%d.log" % (name, task.process)), "a" if attempt > 1 else "w")
+        start = time.time()
+        try:
+            ok = subprocess.call(task.cmd, cwd=task.cwd, env=env, stdout=log, stderr=subprocess.STDOUT) == 0
+        except OSError as e:
+            log.write("%s\n" % e)
+            ok = False
+        log.close()
+        shutil.rmtree(scratch, ignore_errors=True)
+        retry = scheduler.Done(worker, item, ok)
+        report.put((task, attempt, ok, retry, time.time() - start))
+        if ok:
+            done.put(task)
+
+def LocalQueue():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("job", nargs="?", help="Condor submit file")
+    parser.add_argument("-t", "--tasks", help="file with one shell command per line instead of a job")
+    parser.add_argument("-j", "--jobs", type=int, default=0, help="number of workers, all cores by default")
+    parser.add_argument("--memory", help="memory for all tasks, e.g. 64G, 90%% of the node by default")
+    parser.add_argument("--request-memory", default="0", help="memory of each task of a task list")
+    parser.add_argument("--retries", type=int, default=2, help="reruns of a failed task")
+    parser.add_argument("--procs", help="only these processes, e.g. 3,17,40-45")
+    parser.add_argument("--merge", help="merge the outputs into this file")
+    parser.add_argument("--output", help="output of each process, e.g. 'histos/X$(Process).root'")
+    parser.add_argument("--merge-batch", type=int, default=20, help="outputs added per merge step")
+    parser.add_argument("--logdir", default="logs", help="directory of the task logs")
+    args = parser.parse_args()
+
+    if bool(args.job) == bool(args.tasks):
+        parser.error("give either a job file or a task list")
+    if bool(args.merge) != bool(args.output):
+        parser.error("--merge needs --output and vice versa")
+
+    if args.job:
+        tasks = ReadJob(args.job)
+        name = os.path.splitext(os.path.basename(args.job))[0]
+    else:
+        tasks = ReadTaskList(args.tasks, ParseMemory(args.request_memory))
+        name = os.path.splitext(os.path.basename(args.tasks))[0]
+    if args.procs:
+        wanted = set(ParseProcs(args.procs, len(tasks)))
+        tasks = [task for task in tasks if task.process in wanted]
+    if not tasks:
+        print("No tasks to run")
+        return 1
+
+    nworkers = min(args.jobs or os.sysconf("SC_NPROCESSORS_ONLN"), len(tasks))
+    memory = ParseMemory(args.memory) if args.memory else TotalMemory() * 9 // 10
+    if not os.path.isdir(args.logdir):
+        os.makedirs(args.logdir)
+
+    print("%s: %d tasks on %d workers, %d MB per task of %d MB" %
+            (name, len(tasks), nworkers, tasks[0].memory, memory))
+
+    scheduler = Scheduler(tasks, nworkers, memory, args.retries)
+    done = queue.Queue()
+    report = queue.Queue()
+    workers = [threading.Thread(target=Work, args=(i, scheduler, name, args.logdir, done, report))
+            for i in range(nworkers)]
+    for w in workers:
+        w.daemon = True
+        w.start()
+
+    merger = Merger(args.merge, args.merge_batch) if args.merge else None
+    batch = []
+    failed = []
+    nok = 0
+    start = time.time()
+    mergeok = True
+    while any(w.is_alive() for w in workers) or not report.empty():
+        try:
+            task, attempt, ok, retry, elapsed = report.get(timeout=1)
+        except queue.Empty:
+            continue
+        if ok:
+            nok += 1
+            print("[%d/%d] process %d done in %.0f s" % (nok, len(tasks), task.process, elapsed))
+        elif retry:
+            print("process %d failed, attempt %d" % (task.process, attempt))
+        else:
+            failed.append(task.process)
+            print("process %d FAILED, see %s/%s-%d.log" % (task.process, args.logdir, name, task.process))
+
+        # Merge in the main thread, ROOT is not used by the workers
+        while merger and not done.empty():
+            finished = done.get()
+            output = os.path.join(finished.cwd, Substitute(args.output, finished.process, finished.cwd))
+            if os.path.exists(output):
+                batch.append(output)
+            else:
+                print("process %d has no output %s" % (finished.process, output))
+        if merger and len(batch) >= args.merge_batch:
+            mergeok = merger.Merge(batch) and mergeok
+            batch = []
+
+    if merger:
+        mergeok = merger.Merge(batch) and mergeok
+        print("%d outputs merged into %s" % (merger.nmerged, args.merge))
+
+    print("%d done, %d failed, %d stolen in %.0f s" %
+            (nok, len(failed), scheduler.stolen, time.time() - start))
+    if failed:
+        failed.sort()
+        open(name + ".failed", "w").write(",".join(str(p) for p in failed) + "\n")
+        print("Failed processes written to %s.failed" % name)
+    return 0 if not failed and mergeok else 1
+
+if __name__ == "__main__":
+    sys.exit(LocalQueue())
@@ -9,11 +9,14 @@
 class emcGeaTrackContent;
 class emcGeaClusterContainer;
 class emcGeaClusterContent;
+class EmcGeaAssociation;
 
 class AnaTrk
 {
   public:
-    AnaTrk(emcGeaTrackContent *trk, emcGeaClusterContainer *cluscont); 
+    /* With an association table of this event the cluster is taken from it */
+    AnaTrk(emcGeaTrackContent *trk, emcGeaClusterContainer *cluscont,
+        const EmcGeaAssociation *assoc = nullptr);
     virtual ~AnaTrk();
 
     int trkno;
@@ -42,6 +45,8 @@ class AnaTrk
     emcGeaClusterContent *emcclus;
 
   protected:
+    const EmcGeaAssociation *emcassoc;
+
     /* Associate a cluster which has highest energy deposit */
     void FillCluster();
     void FindCluster();
@@ -0,0 +1,66 @@
+#ifndef __EMCGEAASSOCIATION_H__
+#define __EMCGEAASSOCIATION_H__
+
+/* Truth track and cluster association for one event */
+
+#include <emctypes.h>
+
+#include <unordered_map>
+
+class emcGeaTrackContainer;
+class emcGeaTrackContent;
+class emcGeaClusterContainer;
+class emcGeaClusterContent;
+
+/**
+ * Built once per event from the emcGea containers, maps every truth track
+ * to the cluster with its highest energy deposit and every cluster to the
+ * truth track with the highest energy deposit in it, together with that
+ * energy. Tracks are indexed by trkno and clusters by cluster id, so all
+ * lookups are hash lookups instead of a container find() per association.
+ */
+class EmcGeaAssociation
+{
+  public:
+    EmcGeaAssociation();
+    virtual ~EmcGeaAssociation();
+
+    /* Index both containers, replaces the previous event */
+    void Build(emcGeaTrackContainer *trkcont, emcGeaClusterContainer *cluscont);
+    void Clear();
+
+    /* Track by trkno and cluster by cluster id, nullptr if not found */
+    emcGeaTrackContent* GetTrack(emc_trkno_t trkno) const;
+    emcGeaClusterContent* GetCluster(emc_clusterid_t clusid) const;
+
+    /* Cluster with highest energy deposit of this track, nullptr if none */
+    emcGeaClusterContent* GetTrackCluster(emc_trkno_t trkno, float *edep = nullptr) const;
+
+    /* Truth track with highest energy deposit in this cluster, nullptr if none */
+    emcGeaTrackContent* GetClusterTrack(emc_clusterid_t clusid, float *edep = nullptr) const;
+
+    emcGeaClusterContainer* GetClusterContainer() const { return emccluscont; }
+
+  protected:
+    struct TrackEntry
+    {
+      emcGeaTrackContent *trk;
+      emcGeaClusterContent *clus;
+      float edep;
+    };
+
+    struct ClusterEntry
+    {
+      emcGeaClusterContent *clus;
+      emcGeaTrackContent *trk;
+      float edep;
+    };
+
+    emcGeaTrackContainer *emctrkcont;
+    emcGeaClusterContainer *emccluscont;
+
+    std::unordered_map<emc_trkno_t, TrackEntry> tracks;
+    std::unordered_map<emc_clusterid_t, ClusterEntry> clusters;
+};
+
+#endif /* __EMCGEAASSOCIATION_H__ */
@@ -7,6 +7,7 @@
 class PtWeights;
 class ERTSimTrigger;
 class EMCWarnmapChecker;
+class EmcGeaAssociation;
 class DCDeadmapChecker;
 
 class Fun4AllHistoManager;
@@ -66,6 +67,9 @@ class HadronResponse: public SubsysReco
     /* EMC warnmap checker */
     EMCWarnmapChecker *emcwarnmap;
 
+    /* Truth track and cluster association of the current event */
+    EmcGeaAssociation *emcassoc;
+
     /* DC deadmap checker */
     DCDeadmapChecker *dcdeadmap;
 
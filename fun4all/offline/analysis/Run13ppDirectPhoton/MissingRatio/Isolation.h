@@ -3,9 +3,11 @@
 
 #include <SubsysReco.h>
 #include <string>
+#include <vector>
 
 class AnaTrk;
 class EMCWarnmapChecker;
+class EmcGeaAssociation;
 
 class Fun4AllHistoManager;
 class PHCompositeNode;
@@ -29,16 +31,19 @@ class Isolation: public SubsysReco
   protected:
     void BookHistograms();
 
-    /* Sum up energy within cone of fixed opening
-     * Angle rcone around particle with vector anatrk */
-    double SumEEmcal(const AnaTrk *anatrk, double rcone);
-    double SumPTrack(const AnaTrk *anatrk, const PHCentralTrack *tracks, double rcone);
+    /* Sum up energy within cones of opening angles rcone
+     * around particle with vector anatrk, all angles in one pass */
+    void SumEEmcal(const AnaTrk *anatrk, const std::vector<double> &rcone, std::vector<double> &econe);
+    void SumPTrack(const AnaTrk *anatrk, const PHCentralTrack *tracks, const std::vector<double> &rcone, std::vector<double> &econe);
 
     std::string outFileName;
 
     /* EMC warnmap checker */
     EMCWarnmapChecker *emcwarnmap;
 
+    /* Truth track and cluster association of the current event */
+    EmcGeaAssociation *emcassoc;
+
     Fun4AllHistoManager *hm;
     TH1 *h_events;
     THnSparse *hn_photon;
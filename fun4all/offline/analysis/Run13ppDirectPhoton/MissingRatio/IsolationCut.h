@@ -2,11 +2,13 @@
 #define __ISOLATIONCUT_H__
 
 #include <SubsysReco.h>
+#include <AnaToolsTreeColumns.h>
+
 #include <string>
-#include <map>
 #include <vector>
 
 class EMCWarnmapChecker;
+class EmcGeaAssociation;
 
 class emcGeaTrackContent;
 class emcGeaClusterContent;
@@ -35,17 +37,17 @@ class IsolationCut: public SubsysReco
     /** Find truth particle with maximum deposited energy contribution to given cluster */
     emcGeaTrackContent* FindTruthParticle( emcGeaClusterContent* cluster );
 
-    /** Sum and return all the energies of clusters found inside of cone of given radius around
-      a photon candidate */
-    float SumEmcalEnergyInCone( emcClusterContent*,
+    /** Sum all the energies of clusters found inside of cones of given radii around
+      a photon candidate, all radii in one pass */
+    void SumEmcalEnergyInCone( emcClusterContent*,
         emcClusterContainer*,
-        double, double );
+        double, const std::vector<double>&, std::vector<double>& );
 
-    /** Sum and return all the energies (momenta) of charged tracks found inside of cone of given radius around
-      a photon candidate */
-    float SumTrackEnergyInCone( emcClusterContent*,
+    /** Sum all the energies (momenta) of charged tracks found inside of cones of given radii around
+      a photon candidate, all radii in one pass */
+    void SumTrackEnergyInCone( emcClusterContent*,
         PHCentralTrack*,
-        double, double, double );
+        double, double, const std::vector<double>&, std::vector<double>& );
 
     /** Reset global variables that store cluster information for filling output tree */
     void ResetBranchVariables();
@@ -59,6 +61,9 @@ class IsolationCut: public SubsysReco
     /** EMC warnmap checker */
     EMCWarnmapChecker *_emcwarnmap;
 
+    /** truth track and cluster association of the current event */
+    EmcGeaAssociation *_emcassoc;
+
     /** vector with PID's of neutral particles */
     std::vector< int > _v_pid_neutral;
 
@@ -74,16 +79,34 @@ class IsolationCut: public SubsysReco
     /** output tree with truth information */
     TTree* _tree_mcparticles;
 
-    /** map with cluster variables */
-    std::map< std::string , std::vector< float > > _branchmap_cluster;
-
-    /** Map of Event properties that will be written to
-     * output ROOT Tree */
-    std::map< std::string , float > _branchmap_event;
-
-    /** Map of Particle (or cluster) properties that will be written to
-     * output ROOT Tree */
-    std::map< std::string , std::vector< float > > _branchmap_mcparticles;
+    /** Event properties that will be written to both output ROOT Trees */
+    anatools::TreeColumns _columns_event;
+    int _col_eventcounter;
+
+    /** Cluster properties that will be written to output ROOT Tree,
+     * cone columns for the 10 radii have consecutive handles */
+    anatools::TreeColumns _columns_cluster;
+    int _col_cluster_ecore;
+    int _col_cluster_pt;
+    int _col_cluster_prob;
+    int _col_cluster_rcone;
+    int _col_cluster_econe_emcal;
+    int _col_cluster_econe_tracks;
+    int _col_cluster_truth_pdgpid;
+    int _col_cluster_truth_pdgparentpid;
+    int _col_cluster_truth_pid;
+    int _col_cluster_truth_parentpid;
+    int _col_cluster_truth_anclvl;
+
+    /** Particle properties that will be written to output ROOT Tree */
+    anatools::TreeColumns _columns_mcparticles;
+    int _col_t_pid;
+    int _col_t_parentpid;
+    int _col_t_anclvl;
+    int _col_t_ptot;
+    int _col_t_pt;
+    int _col_t_eta;
+    int _col_t_phi;
 
     /** truth tree variables */
     float _truth_pid;
@@ -2,9 +2,12 @@
 #define __MISSINGRATIO_H__
 
 #include <SubsysReco.h>
+#include <AnaToolsDenseHist.h>
+
 #include <string>
 
 class EMCWarnmapChecker;
+class EmcGeaAssociation;
 
 class PHCompositeNode;
 class Fun4AllHistoManager;
@@ -41,6 +44,9 @@ class MissingRatio: public SubsysReco
     /* EMC warnmap checker */
     EMCWarnmapChecker *emcwarnmap;
 
+    /* Truth track and cluster association of the current event */
+    EmcGeaAssociation *emcassoc;
+
     /* 2D histograms for west and east arms with different criterias */
     Fun4AllHistoManager *hm;
     TH1 *h_events;
@@ -56,6 +62,10 @@ class MissingRatio: public SubsysReco
     THnSparse *hn_photon;
     THnSparse *hn_pion;
 
+    /* Dense fill buffers for hn_merge and hn_photon, flushed in End() */
+    anatools::DenseHist<4> hd_merge;
+    anatools::DenseHist<4> hd_photon;
+
     TF1 *cross;
 };
 
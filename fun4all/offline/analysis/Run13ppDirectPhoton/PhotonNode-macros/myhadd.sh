@@ -31,4 +31,4 @@ while read -d " " runnumber ; do
 done < "$PLHF/taxi/Run13pp510MinBias/runlist-DC3sigma.txt"
 #done < "$PLHF/taxi/Run13pp510ERT/runlist-Inseok.txt"
 
-hadd -f "${outdir}/${prename}$1.root" ${files}
+mergeHistos "${outdir}/${prename}$1.root" ${files}
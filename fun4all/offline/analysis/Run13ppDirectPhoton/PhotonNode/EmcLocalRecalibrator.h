@@ -1,11 +1,17 @@
 #ifndef __EMC_LOCAL_RECALIBRATOR_H__
 #define __EMC_LOCAL_RECALIBRATOR_H__
 
+#include <Rtypes.h>
+
 #include <string>
+#include <vector>
+#include <map>
 
 class PhotonContainer;
 class Photon;
 class TF1;
+class TFile;
+class TTree;
 
 /**
  * Class to access calibration correction for ECal from local files.
@@ -23,7 +29,7 @@ class EmcLocalRecalibrator
     /**
      * Destructor
      */
-    ~EmcLocalRecalibrator() {}
+    ~EmcLocalRecalibrator();
 
     /**
      * Correct data for all cluster in cluster container
@@ -31,12 +37,12 @@ class EmcLocalRecalibrator
     void ApplyClusterCorrection( PhotonContainer* photoncont );
 
     /**
-     * Read
+     * Read, the constants of all runs are read from the file on first use
      */
     void ReadEnergyCorrection(const int& a_runnumber);
 
     /**
-     * Read
+     * Read, the file is kept open with an index of the entry of each fill
      */
     void ReadTofCorrection( const int& a_fillnumber );
 
@@ -46,6 +52,7 @@ class EmcLocalRecalibrator
     void SetEnergyCorrectionFile( const std::string a_energycalibrationfile )
     {
       _file_energycalibration = a_energycalibrationfile;
+      _energycalibration_table.clear();
     }
 
     /**
@@ -54,6 +61,7 @@ class EmcLocalRecalibrator
     void SetTofCorrectionFile( const std::string a_tofmapfile )
     {
       _file_tofmap = a_tofmapfile;
+      CloseTofCorrection();
     }
 
     void SelectMB();
@@ -70,6 +78,17 @@ class EmcLocalRecalibrator
      */
     double GetCorrectedTof( const Photon *photon );
 
+    /**
+     * Read run-by-run energy calibration of all runs
+     */
+    void ReadEnergyCorrectionTable();
+
+    /**
+     * Open TOF correction file and index its entries by fill number
+     */
+    void OpenTofCorrection();
+    void CloseTofCorrection();
+
     enum DataType {MB, ERT};
     DataType datatype;
 
@@ -79,9 +98,20 @@ class EmcLocalRecalibrator
     double _tofmap[25000];
     double _energycalibration[8];
 
+    std::map< int, std::vector<double> > _energycalibration_table;
+
+    TFile* _tofmap_file;
+    TTree* _tofmap_tree;
+    std::map<int, Long64_t> _tofmap_index;
+
     TF1* _pbsc_cor_func;
     TF1* _pbgl_cor_func;
     TF1* _pbsc_recor_func;
+
+  private:
+    /* Owns the open TOF correction file */
+    EmcLocalRecalibrator(const EmcLocalRecalibrator&);
+    EmcLocalRecalibrator& operator=(const EmcLocalRecalibrator&);
 };
 
 #endif /* __EMC_LOCAL_RECALIBRATOR_H__ */
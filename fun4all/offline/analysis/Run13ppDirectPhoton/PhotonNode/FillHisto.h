@@ -3,12 +3,17 @@
 
 #include <SubsysReco.h>
 #include <string>
+#include <vector>
 
 class PhotonContainer;
+class PhotonColumns;
+class PhotonEventTag;
 class Photon;
 class PhotonERT;
 class EmcLocalRecalibrator;
 class EmcLocalRecalibratorSasha;
+class StageProfiler;
+class PhotonNodeReader;
 
 class PHCompositeNode;
 class Fun4AllHistoManager;
@@ -33,13 +38,44 @@ class FillHisto: public SubsysReco
     void SelectMB();
     void SelectERT();
 
+    /* Only analyze events whose tag has any of the trigger bits in trig_mask
+     * (PhotonContainer bit convention, 0 for any), |bbc_z| < zmax (negative
+     * for no cut, keeping the events without vertex for the BBC efficiency)
+     * and a photon with at least emin */
+    void SetTagSelection(unsigned short trig_mask, double zmax = -1., double emin = 0.);
+
+    /* Read only the nDST branches matching the space separated patterns in
+     * branches (as TTree::SetBranchStatus, empty for all), e.g.
+     * "DST/PhotonEventTag* DST/PhotonContainer* DST/Sync*", and the branches
+     * named in lazy_branches, e.g. "DST/PhotonContainer", only for events
+     * passing the tag selection, with a read-ahead cache of cachesize_mb
+     * (0 for ROOT default) and asynchronous prefetching; bytes read per event
+     * are reported for each run. inputname is the DST input manager read. */
+    void SetReadOptions(const std::string &branches, const std::string &lazy_branches,
+        int cachesize_mb = 30, bool prefetch = true, const std::string &inputname = "DSTin1");
+
+    /* Per-run histogram files written so far by EndRun() */
+    const std::vector<std::string>& GetOutputFiles() const { return outfiles; }
+
   protected:
+    PhotonContainer* GetPhotonContainer(PHCompositeNode *topNode);
+    int FillEventCounts(const PhotonEventTag *photontag);
+    bool PassTag(const PhotonEventTag *photontag);
+
     int FillClusterTofSpectrum( const PhotonContainer *photoncont, const std::string &quali = "" );
     int FillPi0InvariantMass( const PhotonContainer *photoncont, const std::string &quali = "" );
+
+    /* Same for the column node, read in place without copying the event */
+    int FillClusterTofSpectrum( const PhotonColumns *photoncols, const std::string &quali = "" );
+    int FillPi0InvariantMass( const PhotonColumns *photoncols, const std::string &quali = "" );
+    void FillClusterTof(const Photon *photon, double bbc_t0, TH3 *h3);
+    void FillPi0Pair(const Photon *photon1, const Photon *photon2, double bbc_t0, TH3 *h3);
     int FillBBCEfficiency(const PhotonContainer *photoncont);
-    int FillERTEfficiency(const PhotonContainer *photoncont, const int evtype);
-    int FillPi0Spectrum(const PhotonContainer *photoncont, const int evtype);
-    int FillPhotonSpectrum(const PhotonContainer *photoncont, const int evtype);
+
+    /* Fill all three trigger types in one pass over photons and pairs */
+    int FillERTEfficiency(const PhotonContainer *photoncont);
+    int FillPi0Spectrum(const PhotonContainer *photoncont);
+    int FillPhotonSpectrum(const PhotonContainer *photoncont);
 
     void BookHistograms();
     void EMCRecalibSetup();
@@ -58,10 +94,30 @@ class FillHisto: public SubsysReco
     DataType datatype;
 
     std::string outFileName;
+    std::vector<std::string> outfiles;
     Fun4AllHistoManager *hm;
     EmcLocalRecalibrator *emcrecalib;
     EmcLocalRecalibratorSasha *emcrecalib_sasha;
 
+    // local container for nDST written in column format, and the column
+    // node of the current event (nullptr for object format nDST)
+    PhotonContainer *photoncont_cols;
+    PhotonColumns *photoncols;
+
+    // local tag for nDST written without tag stream
+    PhotonEventTag *photontag_local;
+
+    // event pre-selection on tag, negative tag_zmax for no vertex cut
+    unsigned short tag_trigmask;
+    double tag_zmax;
+    double tag_emin;
+
+    // per-stage timing, only created with DIRECTPHOTON_PROFILE
+    StageProfiler *prof;
+
+    // nDST read settings, only created with SetReadOptions()
+    PhotonNodeReader *reader;
+
     TH1 *h_events;
     TH3 *h3_tof;
     TH3 *h3_tof_raw;
@@ -0,0 +1,99 @@
+#ifndef __PHOTONNODEREADER_H__
+#define __PHOTONNODEREADER_H__
+
+#include <Rtypes.h>
+
+#include <string>
+#include <vector>
+
+class TFile;
+class TTree;
+class TBranch;
+class Fun4AllInputManager;
+
+/**
+ * Read settings for the DST tree of the nDST opened by Fun4AllDstInputManager.
+ * Only branches matching the enabled patterns are read by the input manager,
+ * lazy branches are read only when Load() is called for the current event,
+ * e.g. the photons after the tag selection. The tree gets a read-ahead cache
+ * of the given size for the enabled branches which are not lazy, optionally
+ * with asynchronous prefetching of the next baskets; lazy branches are read
+ * directly so baskets of skipped events are never fetched.
+ * Call Next() for each event to attach to new input files of the input
+ * manager and count events for the bytes read per event. The DST tree is
+ * taken from the file opened by the input manager, once per file; the same
+ * file opened again right after closing it is not noticed. Next() is called
+ * by a module after the input manager has read the entry, so the first entry
+ * of each file is still read with all branches and without the cache, the
+ * settings apply from the second.
+ */
+class PhotonNodeReader
+{
+  public:
+
+    /* Reads the DST of the input manager of this name */
+    PhotonNodeReader(const std::string &a_inputname = "DSTin1");
+
+    /**
+     * Read only branches matching this pattern (as TTree::SetBranchStatus)
+     * and lazy branches, without any pattern all branches are read
+     */
+    void EnableBranch(const std::string &pattern) { enabled.push_back(pattern); }
+
+    /**
+     * Read this branch only on Load()
+     */
+    void SetLazyBranch(const std::string &name) { lazy.push_back(name); }
+
+    /**
+     * Read-ahead cache size in bytes, 0 for ROOT default settings
+     */
+    void SetCacheSize(Long64_t a_cachesize) { cachesize = a_cachesize; }
+
+    /**
+     * Asynchronous prefetching, only applies to files opened afterwards
+     */
+    static void SetAsyncPrefetch(bool prefetch = true);
+
+    /**
+     * Attach to a new input file if needed and count the event
+     */
+    void Next();
+
+    /**
+     * Read lazy branches for the current event
+     */
+    void Load();
+
+    /**
+     * Events, and bytes read from input files, since the last Reset()
+     */
+    Long64_t GetNEvents() const { return nevents; }
+    Long64_t GetBytesRead() const { return bytes_prev + bytes_file; }
+    double GetBytesPerEvent() const { return nevents > 0 ? (double)GetBytesRead() / nevents : 0.; }
+    void Reset();
+
+  protected:
+    bool Attach(const std::string &a_filename);
+    void UpdateBytesRead();
+
+    std::string inputname;
+    Fun4AllInputManager *input;
+    std::string filename;
+
+    std::vector<std::string> enabled;
+    std::vector<std::string> lazy;
+    Long64_t cachesize;
+
+    TFile *file;
+    TTree *tree;
+    std::vector<TBranch*> lazy_branches;
+    Long64_t loaded_entry;
+
+    // bytes read from this input file only, not from other open files
+    Long64_t nevents;
+    Long64_t bytes_prev;   // files detached since, less the current file before, Reset()
+    Long64_t bytes_file;   // current file
+};
+
+#endif /* __PHOTONNODEREADER_H__ */
@@ -0,0 +1,267 @@
+/* Replay PhotonNode nDSTs through FillHisto on one node with several workers.
+ *
+ * Usage: replayPhotonNode [options] filelist
+ *   -d type       ERT (default) or MB data type
+ *   -j nworkers   number of worker processes (default 4)
+ *   -o output     merge all per-run histograms into this file at the end
+ *   -t trig_mask  tag selection on trigger bits, as FillHisto::SetTagSelection
+ *   -z zmax       tag selection on |bbc_z| (default no vertex cut)
+ *   -e emin       tag selection on photon energy (default 0)
+ *   -p            read only tag, photon and sync branches, photons only for
+ *                 events passing the tag selection
+ *   -b branches   branch patterns to read instead of those of -p
+ *   -l lazy       branches read only after the tag selection instead of
+ *                 those of -p, as FillHisto::SetReadOptions
+ *   -c cache_mb   read-ahead cache size in MB (default 30)
+ *
+ * The file list has one nDST per line, lines starting with '#' are skipped.
+ * Each worker is a separate process with its own Fun4AllServer and FillHisto,
+ * so InitRun state (spin pattern, EMCal recalibration) is per worker, and
+ * takes the next file from a shared counter when it is done with the last.
+ * Per-run histograms go to histos-ERT/ or histos-MB/ as in anaFillHisto_ERT.C,
+ * so each run must be in a single nDST. With -o every worker merges its runs
+ * and the partial files are merged once all workers are done.
+ */
+
+#include "FillHisto.h"
+
+#include <Fun4AllServer.h>
+#include <Fun4AllDstInputManager.h>
+#include <recoConsts.h>
+
+#include <TFileMerger.h>
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+namespace
+{
+  bool MergeFiles(const vector<string> &inputs, const string &output)
+  {
+    TFileMerger merger(kFALSE);
+    merger.OutputFile(output.c_str(), "RECREATE");
+    for(unsigned i=0; i<inputs.size(); i++)
+      if( !merger.AddFile(inputs[i].c_str()) )
+        return false;
+    return merger.Merge();
+  }
+
+  /* Process files from the shared counter until the list is exhausted,
+   * returns the number of files that could not be opened */
+  int Worker(int iworker, const vector<string> &files, atomic<int> *next,
+      const string &datatype, unsigned short trig_mask, double zmax, double emin,
+      bool readopts, const string &branches, const string &lazy, int cache_mb, const string &partial)
+  {
+    recoConsts *rc = recoConsts::instance();
+    rc->set_IntFlag("RUNNUMBER",0);
+
+    Fun4AllServer *se = Fun4AllServer::instance();
+    se->Verbosity(0);
+
+    FillHisto *my1 = new FillHisto("FillHisto_TAXI");
+    if( datatype == "MB" )
+      my1->SelectMB();
+    else
+      my1->SelectERT();
+    /* zmax is negative unless -z was given, which keeps the events
+     * without vertex as FillHisto does by default */
+    my1->SetTagSelection(trig_mask, zmax, emin);
+    if(readopts)
+      my1->SetReadOptions(branches, lazy, cache_mb);
+    se->registerSubsystem(my1);
+
+    Fun4AllInputManager *in1 = new Fun4AllDstInputManager("DSTin1", "DST");
+    se->registerInputManager(in1);
+
+    int nfailed = 0;
+    for(int ifile = (*next)++; ifile < (int)files.size(); ifile = (*next)++)
+    {
+      cout << "worker " << iworker << ": " << files[ifile] << endl;
+      if( se->fileopen("DSTin1", files[ifile].c_str()) )
+      {
+        cerr << "worker " << iworker << ": cannot open " << files[ifile] << endl;
+        nfailed++;
+        continue;
+      }
+      se->run(0);
+      se->fileclose("DSTin1");
+    }
+
+    /* Write histograms of the last run */
+    se->End();
+
+    if( !partial.empty() && !my1->GetOutputFiles().empty() &&
+        !MergeFiles(my1->GetOutputFiles(), partial) )
+    {
+      cerr << "worker " << iworker << ": merging into " << partial << " failed" << endl;
+      nfailed++;
+    }
+
+    delete se;
+    return nfailed;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  string datatype = "ERT";
+  int nworkers = 4;
+  string output;
+  unsigned short trig_mask = 0;
+  double zmax = -1.;
+  double emin = 0.;
+  /* read options are only set if any of -p -b -l -c is given */
+  bool readopts = false;
+  string branches;
+  string lazy;
+  int cache_mb = 30;
+
+  int opt;
+  while( (opt = getopt(argc, argv, "d:j:o:t:z:e:pb:l:c:")) != -1 )
+    switch(opt)
+    {
+      case 'd': datatype = optarg; break;
+      case 'j': nworkers = atoi(optarg); break;
+      case 'o': output = optarg; break;
+      case 't': trig_mask = strtoul(optarg, 0, 0); break;
+      case 'z': zmax = atof(optarg); break;
+      case 'e': emin = atof(optarg); break;
+      case 'p':
+        branches = "DST/PhotonEventTag* DST/PhotonContainer* DST/PhotonColumns* DST/Sync*";
+        lazy = "DST/PhotonContainer DST/PhotonColumns";
+        readopts = true;
+        break;
+      case 'b': branches = optarg; readopts = true; break;
+      case 'l': lazy = optarg; readopts = true; break;
+      case 'c': cache_mb = atoi(optarg); readopts = true; break;
+      default:
+        cerr << "Usage: " << argv[0] << " [-d ERT|MB] [-j nworkers] [-o output]"
+          " [-t trig_mask] [-z zmax] [-e emin] [-p] [-b branches] [-l lazy] [-c cache_mb] filelist" << endl;
+        return 1;
+    }
+
+  if( optind != argc - 1 || (datatype != "ERT" && datatype != "MB") )
+  {
+    cerr << "Usage: " << argv[0] << " [-d ERT|MB] [-j nworkers] [-o output]"
+      " [-t trig_mask] [-z zmax] [-e emin] [-p] [-b branches] [-l lazy] [-c cache_mb] filelist" << endl;
+    return 1;
+  }
+
+  ifstream inFiles(argv[optind]);
+  if(!inFiles)
+  {
+    cerr << "Unable to open input file list " << argv[optind] << endl;
+    return 1;
+  }
+
+  vector<string> files;
+  string line;
+  while( getline(inFiles, line) )
+    if( !line.empty() && line[0] != '#' )
+      files.push_back(line);
+
+  if( nworkers < 1 ) nworkers = 1;
+  if( nworkers > (int)files.size() ) nworkers = files.size();
+  if( nworkers == 0 )
+  {
+    cerr << "No input files in " << argv[optind] << endl;
+    return 1;
+  }
+
+  /* Output directory used by FillHisto::EndRun() */
+  mkdir( ("histos-" + datatype).c_str(), 0755 );
+
+  /* File counter shared by all workers */
+  void *shared = mmap(0, sizeof(atomic<int>), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if( shared == MAP_FAILED )
+  {
+    cerr << "Cannot map shared file counter" << endl;
+    return 1;
+  }
+  atomic<int> *next = new(shared) atomic<int>(0);
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+  vector<string> partials;
+  vector<pid_t> pids;
+  for(int iworker=0; iworker<nworkers; iworker++)
+  {
+    string partial;
+    if( !output.empty() )
+    {
+      char suffix[20];
+      sprintf(suffix, ".worker%d", iworker);
+      partial = output + suffix;
+      remove( partial.c_str() );
+    }
+
+    pid_t pid = fork();
+    if( pid == 0 )
+    {
+      int nfailed = Worker(iworker, files, next, datatype, trig_mask, zmax, emin, readopts, branches, lazy, cache_mb, partial);
+      _exit( nfailed ? 1 : 0 );
+    }
+    else if( pid < 0 )
+    {
+      cerr << "Cannot start worker " << iworker << endl;
+      break;
+    }
+
+    pids.push_back(pid);
+    partials.push_back(partial);
+  }
+
+  int status = 0;
+  for(unsigned iworker=0; iworker<pids.size(); iworker++)
+  {
+    int wstatus;
+    waitpid(pids[iworker], &wstatus, 0);
+    if( !WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0 )
+    {
+      cerr << "Worker " << iworker << " failed" << endl;
+      status = 1;
+    }
+  }
+  if( (int)pids.size() < nworkers )
+    status = 1;
+
+  /* Workers without any run leave no partial file */
+  if( !output.empty() )
+  {
+    vector<string> existing;
+    for(unsigned i=0; i<partials.size(); i++)
+      if( access(partials[i].c_str(), F_OK) == 0 )
+        existing.push_back(partials[i]);
+
+    if( existing.empty() || !MergeFiles(existing, output) )
+    {
+      cerr << "Merging into " << output << " failed" << endl;
+      status = 1;
+    }
+    else
+    {
+      for(unsigned i=0; i<existing.size(); i++)
+        remove( existing[i].c_str() );
+    }
+  }
+
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  cout << files.size() << " files with " << pids.size() << " workers in " << seconds << " s" << endl;
+
+  munmap(shared, sizeof(atomic<int>));
+  return status;
+}
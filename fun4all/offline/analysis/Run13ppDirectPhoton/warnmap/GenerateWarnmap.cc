@@ -2,6 +2,7 @@
 #include "GenerateWarnmap.h"
 
 #include <AnaToolsTowerID.h>
+#include <AnaToolsGeometry.h>
 
 #include <vector>
 #include <string>
@@ -16,6 +17,7 @@
 #include <fstream>
 #include <sstream>
 #include <math.h>
+#include <algorithm>
 
 using namespace std;
 
@@ -82,26 +84,7 @@ int direct_photon_pp::GenerateWarnmap::FillHitsFromHistogram( string input_file
     }
 
   /* Fill hitmap with entries from input histogram */
-  int tower_id, tower_sector, tower_y, tower_z,  hit_counts;
-
-  for( int bin = 1; bin <= ntowers_; bin++ )
-    {
-
-      /* bin number is (tower ID) + 1 */
-      tower_id = bin - 1;
-
-      /* Get location of tower for given tower ID */
-      anatools::TowerLocation( tower_id, tower_sector, tower_y, tower_z );
-
-      /* Read hits for this tower from histogram */
-      hit_counts = hin->GetBinContent( bin );
-
-      /* Fill hitmap */
-      hitmap_[tower_sector][tower_z][tower_y] += hit_counts;
-
-      //      cout << "Filling sector = " << tower_sector << " , y = " << tower_y << " , z = " << tower_z << " , hits = " << hit_counts << endl;
-
-    }//bin
+  AddHits( hin );
 
   /* close input file */
   fin->Close();
@@ -138,6 +121,28 @@ int direct_photon_pp::GenerateWarnmap::FillHitsFrom2DHistogram( string input_fil
        << " GeV" << endl;
 
   /* Fill hitmap with entries from input histogram */
+  AddHits( hin , ybin_min , ybin_max );
+
+  /* close input file */
+  fin->Close();
+  fin->Delete();
+
+  return 0;
+}
+
+
+int direct_photon_pp::GenerateWarnmap::AddHits( const TH1 *hin , unsigned ybin_min , unsigned ybin_max )
+{
+  if ( hin == NULL )
+    return 1;
+
+  /* 1D histogram has no y-bins to sum */
+  if ( hin->GetDimension() < 2 )
+    {
+      ybin_min = 0;
+      ybin_max = 0;
+    }
+
   int tower_id, tower_sector, tower_y, tower_z,  hit_counts;
 
   for( int xbin = 1; xbin <= ntowers_; xbin++ )
@@ -148,31 +153,43 @@ int direct_photon_pp::GenerateWarnmap::FillHitsFrom2DHistogram( string input_fil
       /* Get location of tower for given tower ID */
       anatools::TowerLocation( tower_id, tower_sector, tower_y, tower_z );
 
-
       /* loop over seelcted y-bin range */
       for ( unsigned ybin = ybin_min; ybin <= ybin_max; ybin++ )
 	{
-
 	  /* Read hits for this tower from histogram */
 	  hit_counts = hin->GetBinContent( xbin , ybin );
 
 	  /* Fill hitmap */
 	  hitmap_[tower_sector][tower_z][tower_y] += hit_counts;
-
-	  //      cout << "Filling sector = " << tower_sector << " , y = " << tower_y << " , z = " << tower_z << " , hits = " << hit_counts << endl;
-
 	}//ybin
 
     }//bin
 
-  /* close input file */
-  fin->Close();
-  fin->Delete();
-
   return 0;
 }
 
 
+void direct_photon_pp::GenerateWarnmap::Reset()
+{
+  for( unsigned sector = 0; sector < n_sector_; sector++ )
+    for( unsigned tower_z = 0; tower_z < n_tower_z_; tower_z++ )
+      for( unsigned tower_y=0; tower_y < n_tower_y_; tower_y++ )
+	{
+	  hitmap_[sector][tower_z][tower_y] = 0;
+	  warnmap_[sector][tower_z][tower_y] = GOOD;
+	}
+
+  v_iteration_.clear();
+  v_thresholds_.clear();
+  v_means_.clear();
+  v_sdevs_.clear();
+  v_newhot_.clear();
+  v_allhot_.clear();
+
+  return;
+}
+
+
 int direct_photon_pp::GenerateWarnmap::ReadUncalibratedTowers( std::string input_file )
 {
   cout << "Look for uncalibrated towers in " << input_file << endl;
@@ -356,65 +373,152 @@ int direct_photon_pp::GenerateWarnmap::FindHotTowers( int niterations )
 }
 
 
-int direct_photon_pp::GenerateWarnmap::FiducialCutHotTowers()
+/* Calculate hot tower threshold based on median and median absolute deviation of hit frequencies in each sector */
+int direct_photon_pp::GenerateWarnmap::FindHotTowersRobust()
 {
+  /* Scale factor from median absolute deviation to standard deviation of a gaussian */
+  const float mad_to_sdev = 1.4826;
+
+  vector< vector< long > > counts( n_sector_ );
+
+  vector< unsigned > new_hot_found( n_sector_, 0 );
+  vector< unsigned > all_hot_found( n_sector_, 0 );
 
-  //Loop over all PbSc towers
-  for(int sector = 0; sector < 6; sector++ )
+  vector< float > median( n_sector_, 0 );
+  vector< float > sdev( n_sector_, 0 );
+
+  vector< long long > threshold_hot( n_sector_, 0 );
+
+  int sector = 0;
+  int ytower = 0;
+  int ztower = 0;
+
+  /* Collect hits of towers which are not flagged for other reasons than hot */
+  for( int id = 0; id < ntowers_; id++ )
     {
-      for( int y = 0; y < 36; y++ )
+      anatools::TowerLocation(id, sector, ytower, ztower);
+
+      status_tower status = warnmap_[sector][ztower][ytower];
+      if( status != GOOD && status != HOT )
+	continue;
+
+      counts[sector].push_back( hitmap_[sector][ztower][ytower] );
+    }//id
+
+  for( unsigned int isec = 0; isec < n_sector_; isec++ )
+    {
+      vector< long > &c = counts[isec];
+      if( c.empty() )
+	continue;
+
+      /* median by selection */
+      size_t imid = c.size() / 2;
+      nth_element( c.begin(), c.begin() + imid, c.end() );
+      median[isec] = c[imid];
+
+      /* median absolute deviation */
+      for( size_t i = 0; i < c.size(); i++ )
+	c[i] = labs( c[i] - (long)median[isec] );
+      nth_element( c.begin(), c.begin() + imid, c.end() );
+      sdev[isec] = mad_to_sdev * c[imid];
+
+      /* With more than half of the towers at the same count MAD is 0 and any tower above the median
+       * would be hot, so sigma is at least the Poisson fluctuation of the median and at least 1 hit */
+      sdev[isec] = max( sdev[isec], max( sqrtf( median[isec] ), 1.f ) );
+
+      threshold_hot[isec] = median[isec] + nsigma_ * sdev[isec];
+    }
+
+
+  /* Loop over all towers and set those above threshold to status hot */
+  bool hot_cleared = false;
+  for( int id = 0; id < ntowers_; id++ )
+    {
+      anatools::TowerLocation(id, sector, ytower, ztower);
+
+      status_tower &status = warnmap_[sector][ztower][ytower];
+
+      if ( hitmap_[sector][ztower][ytower] > threshold_hot[sector] )
 	{
-	  for( int z = 0; z < 72; z++ )
-	    {
-	      // check if tower is flagged HOT
-	      if( warnmap_[sector][z][y]==HOT )
-		{
-		  // loop over surrounding towers
-		  for(int dz=-1; dz<=1; dz++){
-		    for(int dy=-1; dy<=1; dy++){
+	  all_hot_found[sector]++;
 
-		      // this neighbor does not exist
-		      if ( (z + dz) < 0 || (y + dy) < 0 || (z + dz) >= 72 || (y + dy) >= 36 )
-			continue;
+	  if ( status != HOT )
+	    new_hot_found[sector]++;
 
-		      if( warnmap_[sector][z+dz][y+dy] == GOOD )
-			warnmap_[sector][z+dz][y+dy] = FIDUCIAL_HOT;
-		    }//dy
-		  }//dz
+	  status = HOT;
+	}
+      else if ( status == HOT )
+	{
+	  status = GOOD;
+	  hot_cleared = true;
+	}
+    }
 
-		}//if hot
+  /* Neighbours flagged for a tower which is no longer hot are good again, unless next to another hot tower */
+  if( hot_cleared )
+    {
+      const anatools::EmcGeometry &geom = anatools::EmcGeometry::Instance();
 
-	    }//loop z
-	}//loop y
-    }//loop sector
+      for( int id = 0; id < anatools::EmcGeometry::ntower; id++ )
+	{
+	  sector = geom.GetSector(id);
+	  status_tower &status = warnmap_[sector][geom.GetZ(id)][geom.GetY(id)];
+	  if( status != FIDUCIAL_HOT )
+	    continue;
 
+	  bool next_to_hot = false;
+	  for( int inb = 0; inb < geom.GetNNeighbour(id); inb++ )
+	    {
+	      int id_nb = geom.GetNeighbour(id, inb);
+	      if( warnmap_[sector][geom.GetZ(id_nb)][geom.GetY(id_nb)] == HOT )
+		next_to_hot = true;
+	    }//neighbors
+
+	  if( !next_to_hot )
+	    status = GOOD;
+	}//loop towers
+    }
 
-  //Loop over all PbGl towers
-  for( int sector = 6; sector < 8; sector++ )
+  /* Save summary of this step in vecctors, with median and sigma as mean and sdev */
+  unsigned iteration = v_iteration_.size() + 1;
+  v_iteration_.push_back( iteration );
+  v_thresholds_.push_back( threshold_hot );
+  v_means_.push_back( median );
+  v_sdevs_.push_back( sdev );
+  v_newhot_.push_back( new_hot_found );
+  v_allhot_.push_back( all_hot_found );
+
+  return 0;
+}
+
+
+int direct_photon_pp::GenerateWarnmap::FiducialCutHotTowers()
+{
+  const anatools::EmcGeometry &geom = anatools::EmcGeometry::Instance();
+
+  //Loop over all towers
+  for( int id = 0; id < anatools::EmcGeometry::ntower; id++ )
     {
-      for( int y = 0; y < 48; y++ )
+      int sector = geom.GetSector(id);
+      int y = geom.GetY(id);
+      int z = geom.GetZ(id);
+
+      // check if tower is flagged HOT
+      if( warnmap_[sector][z][y] == HOT )
 	{
-	  for( int z = 0; z < 96; z++ )
+	  // loop over surrounding towers in the same sector
+	  for( int inb = 0; inb < geom.GetNNeighbour(id); inb++ )
 	    {
-	      if( warnmap_[sector][z][y] == HOT )
-		{
-		  for( int dz = -1; dz<=1; dz++ )
-		    {
-		    for( int dy = -1; dy<=1; dy++ )
-		      {
-			// this neighbor does not exist
-			if ( (z + dz) < 0 || (y + dy) < 0 || (z + dz) >= 96 || (y + dy) >= 48 )
-			  continue;
-
-			if( warnmap_[sector][z+dz][y+dy] == GOOD )
-			  warnmap_[sector][z+dz][y+dy] = FIDUCIAL_HOT;
-		      }//dy
-		    }//dz
-
-		}//if hot
-	    }//z
-	}//y
-    }//sector
+	      int id_nb = geom.GetNeighbour(id, inb);
+	      int z_nb = geom.GetZ(id_nb);
+	      int y_nb = geom.GetY(id_nb);
+
+	      if( warnmap_[sector][z_nb][y_nb] == GOOD )
+		warnmap_[sector][z_nb][y_nb] = FIDUCIAL_HOT;
+	    }//neighbors
+
+	}//if hot
+    }//loop towers
 
   return 0;
 }
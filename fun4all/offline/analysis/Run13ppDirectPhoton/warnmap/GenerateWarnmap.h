@@ -40,6 +40,17 @@ namespace direct_photon_pp
     int FillHitsFrom2DHistogram( std::string input_file , std::string input_histogram , unsigned ybin_min , unsigned ybin_max );
 
 
+    /**
+     * Add hits from histogram with tower ID + 1 as x-bin, e.g. from single run. For 2D histograms
+     * sum y-bins from ybin_min to ybin_max. Can be called repeatedly to add up several runs.
+     */
+    int AddHits( const TH1 *hin , unsigned ybin_min = 1 , unsigned ybin_max = 1 );
+
+    /**
+     * Clear hits and tower status to start a new warnmap
+     */
+    void Reset();
+
     /**
      * Read list of uncalibrated towers
      */
@@ -61,6 +72,15 @@ namespace direct_photon_pp
      */
     int FindHotTowers( int niterations );
 
+    /**
+     * Determine hot towers in a single pass with robust estimators: threshold = median + nsigma * sigma
+     * in each sector, with sigma = 1.4826 * median absolute deviation. Hot towers are not needed to be
+     * excluded first, so no iterations are needed. sigma is at least sqrt(median) and 1 hit, so a sector
+     * with MAD = 0 does not flag every tower above the median. Towers flagged HOT before are reevaluated,
+     * towers no longer hot release the FIDUCIAL_HOT flags of their neighbours.
+     */
+    int FindHotTowersRobust();
+
     /**
      * Set towers around hot towers to appropriate status for fiducial volume cut
      */